@@ -16,6 +16,7 @@
 #include "../detail/ForceParameters.hpp"
 #include "../detail/profiles.hpp"
 #include "../detail/subs_t.hpp"
+#include "../detail/counter_rng.hpp"
 
 namespace cases
 {
@@ -279,5 +280,108 @@ namespace cases
       arr(blitz::Range::all(), arr.extent(1) - 1, blitz::Range::all()) =
         arr(blitz::Range::all(), 0, blitz::Range::all());
     }
+
+    /**
+     * @brief Evaluate a height-dependent functor once per model level.
+     *
+     * The resulting 1D table is meant to be copied into 2D/3D arrays with bcast_prof,
+     * so that (possibly expensive, e.g. sounding interpolation) functors are not called at each grid point.
+     */
+    template<class fctr_t>
+    arr_1D_t column_prof(const fctr_t &fctr, const int nz, const real_t &dz)
+    {
+      arr_1D_t prof(nz);
+      for(int k = 0; k < nz; ++k)
+        prof(k) = fctr(k * dz);
+      return prof;
+    }
+
+    /**
+     * @brief Copy a 1D vertical profile into each column of a 2D array; columns are split among OpenMP threads.
+     */
+    template<class arr_t>
+    void bcast_prof(arr_t arr, const arr_1D_t &prof,
+      typename std::enable_if<arr_t::rank_ == 2>::type* = 0)
+    {
+      #pragma omp parallel for
+      for(int i = arr.lbound(0); i <= arr.ubound(0); ++i)
+        arr(i, blitz::Range::all()) = prof(blitz::tensor::i);
+    }
+
+    /**
+     * @brief Copy a 1D vertical profile into each column of a 3D array; columns are split among OpenMP threads.
+     */
+    template<class arr_t>
+    void bcast_prof(arr_t arr, const arr_1D_t &prof,
+      typename std::enable_if<arr_t::rank_ == 3>::type* = 0)
+    {
+      #pragma omp parallel for
+      for(int i = arr.lbound(0); i <= arr.ubound(0); ++i)
+        arr(i, blitz::Range::all(), blitz::Range::all()) = prof(blitz::tensor::j);
+    }
+
+    // shape of the vertical absorber coefficient above z_abs
+    enum vab_shape_t { vab_linear, vab_sin2 };
+
+    /**
+     * @brief Set the vertical absorber coefficient: zero below z_abs, growing up to the domain top
+     * linearly to 1/1020 (vab_linear) or as sin^2 to 1/100 (vab_sin2).
+     */
+    void set_vab_coeff(concurr_any_t &concurr, const int nz, const real_t &dz, const real_t &z_abs, const vab_shape_t shape)
+    {
+      blitz::firstIndex k;
+      arr_1D_t vab_coeff(nz);
+      if(shape == vab_linear)
+        vab_coeff = where(k * dz >= z_abs,  1. / 1020 * (k * dz - z_abs) / (Z / si::metres - z_abs), 0);
+      else
+        vab_coeff = where(k * dz >= z_abs,  1. / 100 * pow(sin(3.1419 / 2. * (k * dz - z_abs)/ (Z / si::metres - z_abs)), 2), 0);
+      bcast_prof(concurr.vab_coefficient(), vab_coeff);
+    }
+
+    /**
+     * @brief Add a random perturbation uniformly distributed in (-ampl(k), ampl(k)) to a 2D array.
+     *
+     * Random numbers come from a counter-based generator keyed by the global grid indices,
+     * so each process/thread fills only its own part of the domain and the result does not depend
+     * on the domain decomposition nor on the number of threads.
+     * The last point in x is the same as the first one (cyclic horizontal boundaries).
+     * NOTE: relies on the arrays returned by concurr.advectee() being indexed with global indices
+     */
+    template<class arr_t>
+    void add_prtrb(arr_t arr, const arr_1D_t &ampl, const int rng_seed, const int nps[n_dims],
+      typename std::enable_if<arr_t::rank_ == 2>::type* = 0)
+    {
+      const detail::philox2x32 rng(rng_seed);
+      #pragma omp parallel for
+      for(int i = arr.lbound(0); i <= arr.ubound(0); ++i)
+      {
+        const uint64_t ic = i == nps[0] - 1 ? 0 : i;
+        for(int k = arr.lbound(1); k <= arr.ubound(1); ++k)
+          arr(i, k) += ampl(k) * rng.uniform(ic * nps[1] + k, -1, 1);
+      }
+    }
+
+    /**
+     * @brief Add a random perturbation uniformly distributed in (-ampl(k), ampl(k)) to a 3D array.
+     *
+     * See the 2D version; the last points in x and in y are the same as the first ones.
+     */
+    template<class arr_t>
+    void add_prtrb(arr_t arr, const arr_1D_t &ampl, const int rng_seed, const int nps[n_dims],
+      typename std::enable_if<arr_t::rank_ == 3>::type* = 0)
+    {
+      const detail::philox2x32 rng(rng_seed);
+      #pragma omp parallel for
+      for(int i = arr.lbound(0); i <= arr.ubound(0); ++i)
+      {
+        const uint64_t ic = i == nps[0] - 1 ? 0 : i;
+        for(int j = arr.lbound(1); j <= arr.ubound(1); ++j)
+        {
+          const uint64_t jc = j == nps[1] - 1 ? 0 : j;
+          for(int k = arr.lbound(2); k <= arr.ubound(2); ++k)
+            arr(i, j, k) += ampl(k) * rng.uniform((ic * nps[1] + jc) * nps[2] + k, -1, 1);
+        }
+      }
+    }
   };
 };
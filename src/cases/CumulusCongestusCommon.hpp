@@ -49,11 +49,11 @@ namespace cases
         return RH * libcloudphxx::common::const_cp::r_vs<real_t>(T, p);
       }
   
-      template <class index_t>
-      void intcond_hlpr(typename parent_t::concurr_any_t &concurr, arr_1D_t &rhod, int rng_seed, index_t index, 
+      void intcond_hlpr(typename parent_t::concurr_any_t &concurr, arr_1D_t &rhod, int rng_seed, 
                         const real_t &th_prtrb, // [K]
                         const real_t &rv_prtrb, // [kg/kg]
-                        const real_t &z_abs)    // [m]
+                        const real_t &z_abs,    // [m]
+                        const int nps[n_dims])
       {
         // we assume here that set_profs was called already, so that *_env profiles are initialized
         int nz = rhod.extent(0) - 1;
@@ -65,42 +65,21 @@ namespace cases
         concurr.advectee(ix::w) = 0;  
        
         // absorbers
-        concurr.vab_coefficient() = where(index * dz >= z_abs,  1. / 100 * pow(sin(3.1419 / 2. * (index * dz - z_abs)/ (this->Z / si::metres - z_abs)), 2), 0);
+        this->set_vab_coeff(concurr, nz, dz, z_abs, parent_t::vab_sin2);
         concurr.vab_relaxed_state(0) = concurr.advectee(ix::u);
         concurr.vab_relaxed_state(ix::w) = concurr.advectee(ix::w);
   
         // density profile
-        concurr.g_factor() = rhod(index); // copy the 1D profile into 2D/3D array
+        this->bcast_prof(concurr.g_factor(), rhod); // copy the 1D profile into 2D/3D array
   
         // randomly prtrb tht and rv in the lowest 1km
-        // NOTE: all processes do this, but ultimately only perturbation calculated by MPI rank 0 is used
         {
-          std::mt19937 gen(rng_seed);
-          std::uniform_real_distribution<> dis(-1*th_prtrb, th_prtrb);
-          auto rand = std::bind(dis, gen);
-  
-          auto th_global = concurr.advectee_global(ix::th);
-          decltype(concurr.advectee(ix::th)) prtrb(th_global.shape()); // array to store perturbation
-          std::generate(prtrb.begin(), prtrb.end(), rand); // fill it, TODO: is it officialy stl compatible?
-
-          prtrb = where(index * dz >= 1000., 0., prtrb); // no perturbation above 1km
-          th_global += prtrb;
-          this->make_cyclic(th_global);
-          concurr.advectee_global_set(th_global, ix::th);
-        }
-        {
-          std::mt19937 gen(rng_seed+1); // different seed than in th. NOTE: if the same instance of gen is used in th and rv, for some reason it gives the same sequence in rv as in th despite being advanced in th prtrb
-          std::uniform_real_distribution<> dis(-1*rv_prtrb, rv_prtrb);
-          auto rand = std::bind(dis, gen);
-  
-          auto rv_global = concurr.advectee_global(ix::rv);
-          decltype(concurr.advectee(ix::rv)) prtrb(rv_global.shape()); // array to store perturbation
-          std::generate(prtrb.begin(), prtrb.end(), rand); // fill it, TODO: is it officialy stl compatible?
-
-          prtrb = where(index * dz >= 1000., 0., prtrb); // no perturbation above 1km
-          rv_global += prtrb;
-          this->make_cyclic(rv_global);
-          concurr.advectee_global_set(rv_global, ix::rv);
+          blitz::firstIndex k;
+          arr_1D_t ampl(nz);
+          ampl = where(k * dz >= 1000., 0., th_prtrb); // no perturbation above 1km
+          this->add_prtrb(concurr.advectee(ix::th), ampl, rng_seed, nps);
+          ampl = where(k * dz >= 1000., 0., rv_prtrb);
+          this->add_prtrb(concurr.advectee(ix::rv), ampl, rng_seed+1, nps); // different seed than in th
         }
       }
   
@@ -25,14 +25,13 @@ namespace cases
       arr_1D_t p_env;
       arr_1D_t rv_env;
   
-      template <class index_t>
-      void intcond_hlpr(typename parent_t::concurr_any_t &concurr, arr_1D_t &rhod, int rng_seed, index_t index) 
+      void intcond_hlpr(typename parent_t::concurr_any_t &concurr, arr_1D_t &rhod, int rng_seed, const int nps[n_dims])
       {
-        concurr.advectee(ix::rv) = rv_env(index);
-        concurr.advectee(ix::th) = th_std_env(index);
+        this->bcast_prof(concurr.advectee(ix::rv), rv_env);
+        this->bcast_prof(concurr.advectee(ix::th), th_std_env);
         concurr.advectee(ix::u) = 0;
 
-        parent_t::intcond_hlpr(concurr, rhod, rng_seed, index, 0.1, 0.025e-3, (this->Z / si::metres) - 1000);
+        parent_t::intcond_hlpr(concurr, rhod, rng_seed, 0.1, 0.025e-3, (this->Z / si::metres) - 1000, nps);
       }
 
       // calculate the initial environmental theta and rv profiles
@@ -198,8 +197,7 @@ namespace cases
       void intcond(typename parent_t::concurr_any_t &concurr,
                    arr_1D_t &rhod, arr_1D_t &th_e, arr_1D_t &rv_e, arr_1D_t &rl_e, arr_1D_t &p_e, int rng_seed, const int nps[2]) override
       {
-        blitz::secondIndex k;
-        this->intcond_hlpr(concurr, rhod, rng_seed, k);
+        this->intcond_hlpr(concurr, rhod, rng_seed, nps);
       }
 
       public:
@@ -229,8 +227,7 @@ namespace cases
       void intcond(typename parent_t::concurr_any_t &concurr,
                    arr_1D_t &rhod, arr_1D_t &th_e, arr_1D_t &rv_e, arr_1D_t &rl_e, arr_1D_t &p_e, int rng_seed, const int nps[3]) override
       {
-        blitz::thirdIndex k;
-        this->intcond_hlpr(concurr, rhod, rng_seed, k);
+        this->intcond_hlpr(concurr, rhod, rng_seed, nps);
 
         int nz = nps[2];
         real_t dz = (this->Z / si::metres) / (nz-1);
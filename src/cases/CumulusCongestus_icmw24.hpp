@@ -7,65 +7,32 @@
 #include "CumulusCongestusCommon.hpp"
 #include "detail/CAMP2EX_sounding/input_sounding_camp2ex_000907-pbl4.hpp"
 #include "detail/CAMP2EX_sounding/aerosol_profile_factor.hpp"
+#include "detail/sounding.hpp"
 
 namespace cases 
 {
   namespace CumulusCongestus
   {
-    // returned units: [K], [g/kg], [m/s], [1]
-    inline real_t interpolate_CAMP2EX_sounding(const std::string valname, real_t pos)
+    // CAMP2EX sounding, columns: z [m], theta [K], rv [g/kg], u [m/s], v [m/s]
+    inline sounding_t CAMP2EX_sounding(const std::string &sounding_file)
     {
-      assert(pos>=0);
-      assert(valname == "theta" || valname == "rv" || valname == "u" || valname == "v" || valname == "aerosol_conc_factor");
-
-      const auto &pos_s(
-        valname == "aerosol_conc_factor" ? CAMP2EX_aerosol_profile_density : CAMP2EX_sounding_z);
-
-      const auto pos_up = 
-        valname == "aerosol_conc_factor" ? std::upper_bound(pos_s.begin(), pos_s.end(), pos, std::greater<double>()) : 
-                                           std::upper_bound(pos_s.begin(), pos_s.end(), pos);
-
-      if(pos_up == pos_s.end())
-        throw std::runtime_error("UWLCM: The initial sounding is not high enough");
-      if(pos_up == pos_s.begin())
-        throw std::runtime_error("UWLCM: The initial hsa incorrect first element (?)");
-
-      const auto &sndg(
-        valname == "theta" ? CAMP2EX_sounding_theta :
-        valname == "rv" ? CAMP2EX_sounding_rv :
-        valname == "u" ? CAMP2EX_sounding_u :
-        valname == "v" ? CAMP2EX_sounding_v :
-        CAMP2EX_aerosol_profile_factor);
-
-      const auto s_up = sndg.begin() + std::distance(pos_s.begin(), pos_up);
-      return real_t(*(s_up-1) + (pos - *(pos_up-1)) / (*pos_up - *(pos_up-1)) * (*s_up - *(s_up-1)));
+      if(sounding_file != "")
+        return sounding_t(sounding_file, "z");
+      return sounding_t(
+        {"z", "theta", "rv", "u", "v"},
+        std::vector<std::vector<double>>{CAMP2EX_sounding_z, CAMP2EX_sounding_theta, CAMP2EX_sounding_rv, CAMP2EX_sounding_u, CAMP2EX_sounding_v},
+        "z"
+      );
     }
 
-    inline quantity<si::velocity, real_t> u_cc_icmw24(const real_t &z)
+    // aerosol concentration factor [1] as a function of air density [kg/m^3]
+    inline sounding_t CAMP2EX_aerosol_profile()
     {
-      return interpolate_CAMP2EX_sounding("u", z) * si::meters / si::seconds;
-      //return 0 * si::meters / si::seconds;
-    }
-
-    inline quantity<si::velocity, real_t> v_cc_icmw24(const real_t &z)
-    {
-      return interpolate_CAMP2EX_sounding("v", z) * si::meters / si::seconds;
-      //return 0 * si::meters / si::seconds;
-    }
-
-    inline quantity<si::temperature, real_t> th_l_cc_icmw24(const real_t &z)
-    {
-      return interpolate_CAMP2EX_sounding("theta", z) * si::kelvins;
-    }
-
-    inline quantity<si::dimensionless, real_t> r_t_cc_icmw24(const real_t &z)
-    {
-      return interpolate_CAMP2EX_sounding("rv", z) * 1e-3; // to [kg/kg]
-    }
-
-    inline quantity<si::dimensionless, real_t> acf_cc_icmw24(const real_t &rhod) // aerosol concentration factor
-    {
-      return interpolate_CAMP2EX_sounding("aerosol_conc_factor", rhod);
+      return sounding_t(
+        {"rhod", "aerosol_conc_factor"},
+        std::vector<std::vector<double>>{CAMP2EX_aerosol_profile_density, CAMP2EX_aerosol_profile_factor},
+        "rhod"
+      );
     }
 
     template<class case_ct_params_t, int n_dims>
@@ -76,33 +43,32 @@ namespace cases
       using ix = typename case_ct_params_t::ix;
       using rt_params_t = typename case_ct_params_t::rt_params_t;
 
+      // sounding read once at setup, columns are accessed by index
+      const sounding_t sndg;
+      const int c_th, c_rv, c_u, c_v;
+
+      // sounding interpolated to model levels in set_profs
+      arr_1D_t th_sndg, rv_sndg;
+
       quantity<si::temperature, real_t> th_l(const real_t &z) override
       {
-        return th_l_cc_icmw24(z);
+        return sndg(c_th, z) * si::kelvins;
       }
 
       quantity<si::dimensionless, real_t> r_t(const real_t &z) override
       {
-        return r_t_cc_icmw24(z);
+        return sndg(c_rv, z) * 1e-3; // to [kg/kg]
       }
 
-      struct th_std_fctr
+      quantity<si::velocity, real_t> u_sndg(const real_t &z)
       {
-        real_t operator()(const real_t &z) const
-        {
-          return th_l_cc_icmw24(z) / si::kelvins;
-        }
-        BZ_DECLARE_FUNCTOR(th_std_fctr);
-      };
+        return sndg(c_u, z) * si::meters / si::seconds;
+      }
 
-      struct r_t_fctr
+      quantity<si::velocity, real_t> v_sndg(const real_t &z)
       {
-        quantity<si::dimensionless, real_t> operator()(const real_t &z) const
-        {
-          return r_t_cc_icmw24(z);
-        }
-        BZ_DECLARE_FUNCTOR(r_t_fctr);
-      };
+        return sndg(c_v, z) * si::meters / si::seconds;
+      }
 
       struct u_t : hori_vel_t
       {
@@ -111,33 +77,35 @@ namespace cases
           return hori_vel_t::operator()(z);
         }
 
-        u_t() : hori_vel_t(&u_cc_icmw24) {}
+        u_t(std::function<quantity<si::velocity, real_t>(real_t)> f) : hori_vel_t(f) {}
 
         BZ_DECLARE_FUNCTOR(u_t);
       };
 
       u_t u;
 
-      template <class index_t>
-      void intcond_hlpr(typename parent_t::concurr_any_t &concurr, arr_1D_t &rhod, int rng_seed, index_t index) 
+      void intcond_hlpr(typename parent_t::concurr_any_t &concurr, arr_1D_t &rhod, int rng_seed, const int nps[n_dims])
       {
         int nz = rhod.extent(0) - 1;
         real_t dz = (this->Z / si::metres) / (nz-1);
 
-        concurr.advectee(ix::th) = th_std_fctr{}(index * dz);
-        concurr.advectee(ix::rv) = r_t_fctr{}(index * dz);
-        concurr.advectee(ix::u) = u(index * dz);
+        // the sounding was interpolated to model levels in set_profs, here it is copied into 2D/3D arrays
+        this->bcast_prof(concurr.advectee(ix::th), th_sndg);
+        this->bcast_prof(concurr.advectee(ix::rv), rv_sndg);
+        this->bcast_prof(concurr.advectee(ix::u), this->column_prof(u, nz, dz));
 
-        parent_t::intcond_hlpr(concurr, rhod, rng_seed, index, 0.1, 0.025e-3, (this->Z / si::metres) - 1000);
+        parent_t::intcond_hlpr(concurr, rhod, rng_seed, 0.1, 0.025e-3, (this->Z / si::metres) - 1000, nps);
       }
 
       template <class T, class U>
       void setopts_hlpr(T &params, const int nz, const U &user_params)
       {
         params.aerosol_independent_of_rhod=true;
+        const sounding_t aer(CAMP2EX_aerosol_profile());
+        const int c_acf = aer.col("aerosol_conc_factor");
         for(int i=0; i<nz; ++i)
         {
-          params.aerosol_conc_factor.push_back(acf_cc_icmw24((*params.rhod)(i)));
+          params.aerosol_conc_factor.push_back(aer(c_acf, (*params.rhod)(i)));
         }
         parent_t::setopts_hlpr(params, user_params);
       }
@@ -148,6 +116,12 @@ namespace cases
       {
         parent_t::set_profs(profs, nz, user_params);
 
+        real_t dz = (this->Z / si::metres) / (nz-1);
+        th_sndg.resize(nz);
+        rv_sndg.resize(nz);
+        th_sndg = sndg.profile(c_th, nz, dz);
+        rv_sndg = sndg.profile(c_rv, nz, dz) * 1e-3; // to [kg/kg]
+
         this->env_prof(profs, nz);
         this->ref_prof(profs, nz);
 
@@ -203,7 +177,13 @@ namespace cases
       }
 
       // ctor
-      CumulusCongestusCommon_icmw24(const real_t _X, const real_t _Y, const real_t _Z, const bool window)
+      CumulusCongestusCommon_icmw24(const real_t _X, const real_t _Y, const real_t _Z, const bool window, const std::string &sounding_file) :
+        sndg(CAMP2EX_sounding(sounding_file)),
+        c_th(sndg.col("theta")),
+        c_rv(sndg.col("rv")),
+        c_u(sndg.col("u")),
+        c_v(sndg.col("v")),
+        u(std::bind(&CumulusCongestusCommon_icmw24::u_sndg, this, std::placeholders::_1))
       {
         init();
 
@@ -235,13 +215,12 @@ namespace cases
       void intcond(typename parent_t::concurr_any_t &concurr,
                    arr_1D_t &rhod, arr_1D_t &th_e, arr_1D_t &rv_e, arr_1D_t &rl_e, arr_1D_t &p_e, int rng_seed, const int nps[2]) override
       {
-        blitz::secondIndex k;
-        this->intcond_hlpr(concurr, rhod, rng_seed, k);
+        this->intcond_hlpr(concurr, rhod, rng_seed, nps);
       }
 
       public:
-      CumulusCongestus_icmw24(const real_t _X, const real_t _Y, const real_t _Z, const bool window):
-        parent_t(_X, _Y, _Z, window)
+      CumulusCongestus_icmw24(const real_t _X, const real_t _Y, const real_t _Z, const bool window, const std::string &sounding_file = ""):
+        parent_t(_X, _Y, _Z, window, sounding_file)
       {
         this->X = _X < 0 ? 12e3 * si::meters : _X * si::meters;
       }
@@ -261,7 +240,7 @@ namespace cases
           return hori_vel_t::operator()(z);
         }
 
-        v_t() : hori_vel_t(&v_cc_icmw24) {}
+        v_t(std::function<quantity<si::velocity, real_t>(real_t)> f) : hori_vel_t(f) {}
 
         BZ_DECLARE_FUNCTOR(v_t);
       };
@@ -280,19 +259,19 @@ namespace cases
       void intcond(typename parent_t::concurr_any_t &concurr,
                    arr_1D_t &rhod, arr_1D_t &th_e, arr_1D_t &rv_e, arr_1D_t &rl_e, arr_1D_t &p_e, int rng_seed, const int nps[3]) override
       {
-        blitz::thirdIndex k;
         int nz = nps[2];
         real_t dz = (this->Z / si::metres) / (nz-1);
 
-        concurr.advectee(ix::v)= v(k * dz);
+        this->bcast_prof(concurr.advectee(ix::v), this->column_prof(v, nz, dz));
         concurr.vab_relaxed_state(1) = concurr.advectee(ix::v);
 
-        this->intcond_hlpr(concurr, rhod, rng_seed, k);
+        this->intcond_hlpr(concurr, rhod, rng_seed, nps);
       }
 
       public:
-      CumulusCongestus_icmw24(const real_t _X, const real_t _Y, const real_t _Z, const bool window):
-        parent_t(_X, _Y, _Z, window)
+      CumulusCongestus_icmw24(const real_t _X, const real_t _Y, const real_t _Z, const bool window, const std::string &sounding_file = ""):
+        parent_t(_X, _Y, _Z, window, sounding_file),
+        v(std::bind(&CumulusCongestus_icmw24::v_sndg, this, std::placeholders::_1))
       {
         this->X = _X < 0 ? 12e3 * si::meters : _X * si::meters;
         this->Y = _Y < 0 ? 12e3 * si::meters : _Y * si::meters;
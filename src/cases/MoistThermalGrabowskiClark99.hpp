@@ -166,9 +166,8 @@ namespace cases
         this->setopts_sgs(params);
       }
     
-      template <class index_t>
       void intcond_hlpr(typename parent_t::concurr_any_t &concurr,
-                        arr_1D_t &rhod, arr_1D_t &th_e, arr_1D_t &rv_e, arr_1D_t &rl_e, int rng_seed, index_t index)
+                        arr_1D_t &rhod, arr_1D_t &th_e, arr_1D_t &rv_e, arr_1D_t &rl_e, int rng_seed)
       {
         int nz = rhod.extent(0) - 1;
         real_t dz = (this->Z / si::metres) / (nz-1); 
@@ -177,15 +176,15 @@ namespace cases
         concurr.advectee(ix::w) = 0;  
        
         // absorbers
-        concurr.vab_coefficient() = where(index * dz >= z_abs,  1. / 100 * pow(sin(3.1419 / 2. * (index * dz - z_abs)/ (this->Z / si::metres - z_abs)), 2), 0);
+        this->set_vab_coeff(concurr, nz, dz, z_abs, parent_t::vab_sin2);
         concurr.vab_relaxed_state(0) = 0;
         concurr.vab_relaxed_state(ix::w) = 0; // vertical relaxed state
     
         // density profile
-        concurr.g_factor() = rhod(index); // copy the 1D profile into 2D/3D array
+        this->bcast_prof(concurr.g_factor(), rhod); // copy the 1D profile into 2D/3D array
     
         // initial potential temperature
-        concurr.advectee(ix::th) = th_e(index); 
+        this->bcast_prof(concurr.advectee(ix::th), th_e); 
       }
     
     
@@ -338,8 +337,7 @@ namespace cases
       void intcond(typename parent_t::concurr_any_t &concurr,
                    arr_1D_t &rhod, arr_1D_t &th_e, arr_1D_t &rv_e, arr_1D_t &rl_e, arr_1D_t &p_e, int rng_seed, const int nps[2]) override
       {
-        blitz::secondIndex k;
-        this->intcond_hlpr(concurr, rhod, th_e, rv_e, rl_e, rng_seed, k);
+        this->intcond_hlpr(concurr, rhod, th_e, rv_e, rl_e, rng_seed);
 
 //        arr_1D_t p_d_e(p_e - detail::calc_p_v()(p_e, rv_e));
         arr_1D_t T(th_e * pow(p_e / 1.e5, R_d_over_c_pd<setup::real_t>()));
@@ -387,8 +385,7 @@ namespace cases
       void intcond(typename parent_t::concurr_any_t &concurr,
                    arr_1D_t &rhod, arr_1D_t &th_e, arr_1D_t &rv_e, arr_1D_t &rl_e, arr_1D_t &p_e, int rng_seed, const int nps[3]) override
       {
-        blitz::thirdIndex k;
-        this->intcond_hlpr(concurr, rhod, th_e, rv_e, rl_e, rng_seed, k);
+        this->intcond_hlpr(concurr, rhod, th_e, rv_e, rl_e, rng_seed);
 
 //        arr_1D_t p_d_e(p_e - detail::calc_p_v()(p_e, rv_e));
         arr_1D_t T(th_e * pow(p_e / 1.e5, R_d_over_c_pd<setup::real_t>()));
@@ -265,54 +265,35 @@ namespace cases
  * @param concurr Concurrency object with advectee arrays
  * @param rhod 1D dry air density profile
  * @param rng_seed Random number seed for perturbations
- * @param index Blitz index used for vertical slicing
  */
-      template <class index_t>
-      void intcond_hlpr(typename parent_t::concurr_any_t &concurr, arr_1D_t &rhod, int rng_seed, index_t index)
+      void intcond_hlpr(typename parent_t::concurr_any_t &concurr, arr_1D_t &rhod, int rng_seed, const int nps[n_dims])
       {
         int nz = rhod.extent(0) - 1; // rhod profile has the size nz+1
         real_t dz = (this->Z / si::metres) / (nz-1); 
   
-        concurr.advectee(ix::rv) = r_t_fctr{}(index * dz); 
-        concurr.advectee(ix::u)= u(index * dz);
+        // profiles evaluated once per level and then copied into 2D/3D arrays
+        this->bcast_prof(concurr.advectee(ix::rv), this->column_prof(r_t_fctr{}, nz, dz)); 
+        this->bcast_prof(concurr.advectee(ix::u), this->column_prof(u, nz, dz));
         concurr.advectee(ix::w) = 0;  
        
         // absorbers
-        concurr.vab_coefficient() = where(index * dz >= z_abs,  1. / 1020 * (index * dz - z_abs) / (this->Z / si::metres - z_abs), 0);
+        this->set_vab_coeff(concurr, nz, dz, z_abs, parent_t::vab_linear);
         concurr.vab_relaxed_state(0) = concurr.advectee(ix::u);
         concurr.vab_relaxed_state(ix::w) = 0; // vertical relaxed state
   
         // density profile
-        concurr.g_factor() = rhod(index); // copy the 1D profile into 2D/3D array
+        this->bcast_prof(concurr.g_factor(), rhod); // copy the 1D profile into 2D/3D array
   
         // initial potential temperature
-        concurr.advectee(ix::th) = th_std_fctr{}(index * dz); 
+        this->bcast_prof(concurr.advectee(ix::th), this->column_prof(th_std_fctr{}, nz, dz)); 
 
         // randomly prtrb tht and rv
-        // NOTE: all processes do this, but ultimately only perturbation calculated by MPI rank 0 is used
         {
-          std::mt19937 gen(rng_seed);
-          std::uniform_real_distribution<> dis(-0.1, 0.1);
-          auto rand = std::bind(dis, gen);
-  
-          auto th_global = concurr.advectee_global(ix::th);
-          decltype(concurr.advectee(ix::th)) prtrb(th_global.shape()); // array to store perturbation
-          std::generate(prtrb.begin(), prtrb.end(), rand); // fill it, TODO: is it officialy stl compatible?
-          th_global += prtrb;
-          this->make_cyclic(th_global);
-          concurr.advectee_global_set(th_global, ix::th);
-        }
-        {
-          std::mt19937 gen(rng_seed+1); // different seed than in th. NOTE: if the same instance of gen is used in th and rv, for some reason it gives the same sequence in rv as in th despite being advanced in th prtrb
-          std::uniform_real_distribution<> dis(-0.025e-3, 0.025e-3);
-          auto rand = std::bind(dis, gen);
-  
-          auto rv_global = concurr.advectee_global(ix::rv);
-          decltype(concurr.advectee(ix::rv)) prtrb(rv_global.shape()); // array to store perturbation
-          std::generate(prtrb.begin(), prtrb.end(), rand); // fill it, TODO: is it officialy stl compatible?
-          rv_global += prtrb;
-          this->make_cyclic(rv_global);
-          concurr.advectee_global_set(rv_global, ix::rv);
+          arr_1D_t ampl(nz);
+          ampl = 0.1;
+          this->add_prtrb(concurr.advectee(ix::th), ampl, rng_seed, nps);
+          ampl = 0.025e-3;
+          this->add_prtrb(concurr.advectee(ix::rv), ampl, rng_seed+1, nps); // different seed than in th
         }
       }
 
@@ -453,8 +434,7 @@ namespace cases
 
       void intcond(typename parent_t::concurr_any_t &concurr, arr_1D_t &rhod, arr_1D_t &th_e, arr_1D_t &rv_e, arr_1D_t &rl_e, arr_1D_t &p_e, int rng_seed, const int nps[2]) override
       {
-       // blitz::secondIndex k;
-        this->intcond_hlpr(concurr, rhod, rng_seed, blitz::secondIndex{});
+        this->intcond_hlpr(concurr, rhod, rng_seed, nps);
       }
     };
 
@@ -491,13 +471,12 @@ namespace cases
 
       void intcond(typename parent_t::concurr_any_t &concurr, arr_1D_t &rhod, arr_1D_t &th_e, arr_1D_t &rv_e, arr_1D_t &rl_e, arr_1D_t &p_e, int rng_seed, const int nps[3]) override
       {
-        blitz::thirdIndex k;
-        this->intcond_hlpr(concurr, rhod, rng_seed, k);
+        this->intcond_hlpr(concurr, rhod, rng_seed, nps);
 
         int nz = nps[2];
         real_t dz = (this->Z / si::metres) / (nz-1);
 
-        concurr.advectee(ix::v)= v(k * dz);
+        this->bcast_prof(concurr.advectee(ix::v), this->column_prof(v, nz, dz));
         concurr.vab_relaxed_state(1) = concurr.advectee(ix::v);
       }
 
@@ -0,0 +1,179 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ */
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+#include <H5Cpp.h>
+
+#include "../../detail/setup.hpp"
+
+namespace cases
+{
+  /**
+   * @brief Vertical sounding: named columns of values given at the levels of one of them (the coordinate, e.g. height).
+   *
+   * Can be created from in-memory vectors (compiled-in soundings) or read at runtime from a file:
+   * - HDF5 (.h5): each column is a 1D dataset in the root group,
+   * - text: first non-comment line holds column names, following lines hold values;
+   *   values are separated by whitespace and/or commas, lines starting with '#' are comments.
+   * Coordinate values have to be monotonic (increasing or decreasing).
+   * Columns are accessed via indices obtained once with col(), no name lookups during interpolation.
+   */
+  class sounding_t
+  {
+    using real_t = setup::real_t;
+    using arr_1D_t = setup::arr_1D_t;
+
+    std::vector<std::string> names;
+    std::vector<std::vector<double>> cols; // stored in double precision, as the compiled-in soundings
+    int crd;
+    bool decreasing;
+
+    void check()
+    {
+      if(cols.empty() || cols.size() != names.size())
+        throw std::runtime_error("UWLCM: sounding has no columns or column names do not match the data");
+      for(const auto &c : cols)
+        if(c.size() != cols[crd].size())
+          throw std::runtime_error("UWLCM: sounding columns have different lengths");
+      if(cols[crd].size() < 2)
+        throw std::runtime_error("UWLCM: sounding needs at least two levels");
+
+      const auto &z(cols[crd]);
+      decreasing = z.front() > z.back();
+      if(decreasing ? !std::is_sorted(z.begin(), z.end(), std::greater<double>()) : !std::is_sorted(z.begin(), z.end()))
+        throw std::runtime_error("UWLCM: sounding coordinate " + names[crd] + " is not monotonic");
+    }
+
+    // index of the first level above (in the direction of the coordinate) pos
+    std::size_t upper(const real_t &pos) const
+    {
+      const auto &z(cols[crd]);
+      const auto pos_up = decreasing ? std::upper_bound(z.begin(), z.end(), pos, std::greater<double>()) :
+                                       std::upper_bound(z.begin(), z.end(), pos);
+
+      if(pos_up == z.end())
+        throw std::runtime_error("UWLCM: The initial sounding is not high enough");
+      if(pos_up == z.begin())
+        throw std::runtime_error("UWLCM: The initial sounding does not cover the lowest level");
+      return std::distance(z.begin(), pos_up);
+    }
+
+    void read_text(const std::string &path)
+    {
+      std::ifstream in(path);
+      if(!in.is_open())
+        throw std::runtime_error("UWLCM: could not open sounding file " + path);
+
+      std::string line;
+      while(std::getline(in, line))
+      {
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream ss(line);
+        std::string tok;
+        if(!(ss >> tok) || tok[0] == '#') continue;
+
+        if(names.empty()) // header
+        {
+          do names.push_back(tok); while(ss >> tok);
+          cols.resize(names.size());
+          continue;
+        }
+
+        std::size_t c = 0;
+        do
+        {
+          if(c == names.size())
+            throw std::runtime_error("UWLCM: too many values in a line of sounding file " + path);
+          cols[c++].push_back(std::stod(tok));
+        } while(ss >> tok);
+        if(c != names.size())
+          throw std::runtime_error("UWLCM: too few values in a line of sounding file " + path);
+      }
+    }
+
+    void read_hdf5(const std::string &path)
+    {
+      H5::H5File h5f(path, H5F_ACC_RDONLY);
+      for(hsize_t i = 0; i < h5f.getNumObjs(); ++i)
+      {
+        if(h5f.getObjTypeByIdx(i) != H5G_DATASET) continue;
+        const std::string name = h5f.getObjnameByIdx(i);
+        H5::DataSet dataset = h5f.openDataSet(name);
+        H5::DataSpace dataspace = dataset.getSpace();
+        if(dataspace.getSimpleExtentNdims() != 1) continue;
+
+        hsize_t n;
+        dataspace.getSimpleExtentDims(&n);
+        std::vector<double> data(n);
+        dataset.read(data.data(), H5::PredType::NATIVE_DOUBLE);
+
+        names.push_back(name);
+        cols.emplace_back(data.begin(), data.end());
+      }
+    }
+
+    public:
+
+    // index of a column with a given name
+    int col(const std::string &name) const
+    {
+      const auto it = std::find(names.begin(), names.end(), name);
+      if(it == names.end())
+        throw std::runtime_error("UWLCM: sounding has no column named " + name);
+      return std::distance(names.begin(), it);
+    }
+
+    // linear interpolation of column c to coordinate pos
+    real_t operator()(const int c, const real_t &pos) const
+    {
+      const auto &z(cols[crd]);
+      const auto &s(cols[c]);
+      const std::size_t up = upper(pos);
+      return real_t(s[up-1] + (pos - z[up-1]) / (z[up] - z[up-1]) * (s[up] - s[up-1]));
+    }
+
+    // table of column c interpolated to model levels z = k * dz + offset, k = 0, ..., nz-1
+    arr_1D_t profile(const int c, const int nz, const real_t &dz, const real_t &offset = 0) const
+    {
+      arr_1D_t prof(nz);
+      for(int k = 0; k < nz; ++k)
+        prof(k) = operator()(c, k * dz + offset);
+      return prof;
+    }
+
+    // from in-memory columns
+    template<class vec_t>
+    sounding_t(const std::vector<std::string> &_names, const std::vector<vec_t> &_cols, const std::string &crd_name) :
+      names(_names)
+    {
+      for(const auto &c : _cols)
+        cols.emplace_back(c.begin(), c.end());
+      crd = col(crd_name);
+      check();
+    }
+
+    // from a file, HDF5 if the name ends with .h5, text otherwise
+    sounding_t(const std::string &path, const std::string &crd_name)
+    {
+      if(path.size() > 3 && path.compare(path.size() - 3, 3, ".h5") == 0)
+        read_hdf5(path);
+      else
+        read_text(path);
+      crd = col(crd_name);
+      check();
+    }
+  };
+};
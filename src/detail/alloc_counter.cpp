@@ -0,0 +1,75 @@
+// replacement of the global operator new that counts heap allocations, compiled only with UWLCM_TIMING
+// used to check that timestepping does not allocate memory
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "alloc_counter.hpp"
+
+namespace
+{
+  std::atomic<unsigned long long> n_allocs(0);
+
+  void *counted_malloc(std::size_t size)
+  {
+    n_allocs.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size == 0 ? 1 : size);
+  }
+};
+
+unsigned long long detail::n_heap_allocs()
+{
+  return n_allocs.load(std::memory_order_relaxed);
+}
+
+void *operator new(std::size_t size)
+{
+  void *p = counted_malloc(size);
+  if(!p) throw std::bad_alloc();
+  return p;
+}
+
+void *operator new[](std::size_t size)
+{
+  return operator new(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+  return counted_malloc(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+  return counted_malloc(size);
+}
+
+void operator delete(void *p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete[](void *p) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept
+{
+  std::free(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept
+{
+  std::free(p);
+}
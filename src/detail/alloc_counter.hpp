@@ -0,0 +1,8 @@
+#pragma once
+
+// number of heap allocations (calls to operator new) made so far by all threads of the process,
+// counted only if UWLCM_TIMING is defined (alloc_counter.cpp replaces the global operator new)
+namespace detail
+{
+  unsigned long long n_heap_allocs();
+};
@@ -0,0 +1,57 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace detail
+{
+  // counter-based random number generator (Philox2x32-10 from Salmon et al. 2011, doi:10.1145/2063384.2063405)
+  // the value returned for a given counter depends only on the key (seed) and on the counter,
+  // hence each process/thread can draw numbers for its own part of the domain without generating the whole sequence
+  class philox2x32
+  {
+    const uint32_t key;
+
+    static constexpr uint32_t mult = 0xD256D193;
+    static constexpr uint32_t weyl = 0x9E3779B9;
+    static constexpr int n_rounds = 10;
+
+    public:
+
+    // random 32-bit integer for the given counter
+    uint32_t operator()(const uint64_t ctr) const
+    {
+      uint32_t x0 = uint32_t(ctr),
+               x1 = uint32_t(ctr >> 32),
+               k = key;
+      for(int r = 0; r < n_rounds; ++r)
+      {
+        const uint64_t prod = uint64_t(mult) * x0;
+        x0 = uint32_t(prod >> 32) ^ k ^ x1;
+        x1 = uint32_t(prod);
+        k += weyl;
+      }
+      return x0;
+    }
+
+    // uniformly distributed in (0, 1)
+    double uniform(const uint64_t ctr) const
+    {
+      return (double(operator()(ctr)) + 0.5) / 4294967296.;
+    }
+
+    // uniformly distributed in (a, b)
+    double uniform(const uint64_t ctr, const double a, const double b) const
+    {
+      return a + (b - a) * uniform(ctr);
+    }
+
+    philox2x32(const uint32_t key) : key(key) {}
+  };
+};
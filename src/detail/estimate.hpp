@@ -0,0 +1,131 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ */
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <stdexcept>
+
+#include "mem_ledger.hpp"
+
+namespace detail
+{
+  // pre-flight estimate of memory per process and of output volume of a run (see --estimate),
+  // filled without allocating anything by the static estimate() of the solvers, which mirror their alloc() and diag()
+  class estimate_t
+  {
+    const std::vector<int> nps; // global grid size
+    const int n_procs, halo;
+    const std::size_t real_size;
+
+    // grid cells of a process (the domain is divided among processes in x), including halos; srfc: horizontal only
+    unsigned long long cells(const bool srfc) const
+    {
+      unsigned long long res = 1;
+      for(int d = 0; d < int(nps.size()) - (srfc ? 1 : 0); ++d)
+        res *= (d == 0 ? local_nx() : nps[d]) + 2 * halo;
+      return res;
+    }
+
+    // grid cells of the whole domain, as in the output
+    unsigned long long cells_out(const bool srfc) const
+    {
+      unsigned long long res = 1;
+      for(int d = 0; d < int(nps.size()) - (srfc ? 1 : 0); ++d)
+        res *= nps[d];
+      return res;
+    }
+
+    // numbers of fields written in each output step and in output steps of spectra
+    int n_out = 0, n_out_srfc = 0, n_out_spec = 0;
+
+    public:
+
+    mem_ledger_t mem; // per process
+    int outfreq_spec = 0; // output frequency of spectra, 0 for outfreq
+
+    estimate_t(const std::vector<int> &nps, const int n_procs, const int halo, const std::size_t real_size) :
+      nps(nps), n_procs(n_procs), halo(halo), real_size(real_size)
+    {
+      if(n_procs < 1 || n_procs > nps[0])
+        throw std::runtime_error("UWLCM: the number of processes in the estimate has to be between 1 and nx");
+    }
+
+    int procs() const { return n_procs; }
+    int n(const int d) const { return nps[d]; }
+
+    // x size of the largest subdomain
+    int local_nx() const { return (nps[0] + n_procs - 1) / n_procs; }
+
+    // n arrays of the size of the grid (with halos) of each process
+    void arrays(const std::string &file, const std::string &purpose, const int n, const bool srfc = false)
+    {
+      mem.add(file, purpose, n * cells(srfc) * real_size);
+    }
+
+    // n fields written in each output step
+    void fields(const int n, const bool srfc = false)
+    {
+      (srfc ? n_out_srfc : n_out) += n;
+    }
+
+    // n fields written in output steps of spectra
+    void spec_fields(const int n)
+    {
+      n_out_spec += n;
+    }
+
+    unsigned long long out_bytes(const bool spec) const
+    {
+      return ((spec ? n_out_spec : n_out) * cells_out(false) + (spec ? 0 : n_out_srfc) * cells_out(true)) * real_size;
+    }
+
+    void print(std::ostream &os, const int nt, const int outfreq, const int outstart, const int outwindow) const
+    {
+      os << "estimate for a " << nps.size() << "D grid of";
+      for(auto n : nps) os << " " << n;
+      os << " cells divided among " << n_procs << " processes (" << local_nx() << " columns in x per process)" << std::endl;
+      mem.print(os, "memory per process [MB]");
+
+      // steps with output, as in libmpdata++; the initial state is also written
+      int n_steps = 0, n_steps_spec = 0;
+      for(int t = 0; outfreq > 0 && t <= nt; ++t)
+        if(t % outfreq < outwindow && t >= outstart)
+        {
+          ++n_steps;
+          if(t % (outfreq_spec > 0 ? outfreq_spec : outfreq) == 0) ++n_steps_spec;
+        }
+      os << "output (without metadata and profiles) [MB]: " << std::endl
+        << "  per output step: " << out_bytes(false) / 1e6 << " (" << n_out << " fields, " << n_out_srfc << " surface fields)" << std::endl
+        << "  per output step of spectra: " << out_bytes(true) / 1e6 << " (" << n_out_spec << " fields)" << std::endl
+        << "  total: " << (n_steps * out_bytes(false) + n_steps_spec * out_bytes(true)) / 1e6
+        << " (" << n_steps << " output steps, " << n_steps_spec << " with spectra)" << std::endl;
+    }
+
+    // memory measured in the calibration steps and wall time extrapolated to nt timesteps,
+    // measured is the ledger of the calibration run, with marks at setup, init and end
+    void print_calibration(std::ostream &os, const mem_ledger_t &measured, const int steps, const int nt) const
+    {
+#if defined(USE_MPI)
+      if(boost::mpi::communicator().rank() != 0) return;
+#endif
+      const double
+        t_init = measured.seconds("setup", "init"),
+        t_step = measured.seconds("init", "end") / steps;
+      os << "calibration with " << steps << " timesteps:" << std::endl;
+      os << "  memory allocated per process [MB]: " << measured.total() / 1e6 << " (estimate: " << mem.total() / 1e6 << ", see the ledger above)" << std::endl
+        << "  peak RSS [MB]: " << measured.peak_rss("end") / 1e3 << std::endl
+        << "  initialization [s]: " << t_init << std::endl
+        << "  per timestep [s]: " << t_step << std::endl
+        << "  extrapolated wall time of " << nt << " timesteps [h]: " << std::setprecision(3) << (t_init + t_step * nt) / 3600.
+        << " (without output)" << std::endl;
+    }
+  };
+};
@@ -1,161 +1,244 @@
 #include <chrono>
-
+#include "profiler.hpp"
+#include "mem_ledger.hpp"
+#if defined(UWLCM_TIMING)
+  #include "alloc_counter.hpp"
+#endif
+
+// times hooks of the solver and the parts of the timestep done in libmpdata++ between them (see detail::profiler_t);
+// each thread times itself, no barriers are added in the loop
 template <class solver_t>
 class exec_timer : public solver_t
 {
   using parent_t = solver_t;
+  using clock = detail::profiler_t::clock;
 
   private:
   const unsigned long nt;
 
-  setup::clock::time_point tbeg_step, tend_step,
-                           tbeg_aux , tend_aux ,
-                           tbeg_loop, tend_loop;
+  detail::profiler_t *prof; // nullptr if profiling is off
+  detail::status_t *status; // nullptr if the status file is off
 
-  setup::timer tloop, trecord_all, thas, thads, thps, thps_has, thas_hads, thads_hps, thmas, thmps;
+  // region done in libmpdata++ between top-level hooks, timed as a scope opened at the end of a hook and closed at the start of the next one
+  int gap_node = -1;
+  clock::time_point tbeg_gap;
 
-  void get_step_time(setup::timer &timer)
+  void gap_end()
   {
-    this->mem->barrier();
-    if (this->rank == 0) 
-    {
-      tend_step = setup::clock::now();
-      timer += std::chrono::duration_cast<setup::timer>( tend_step - tbeg_step );
-      tbeg_step = setup::clock::now();
-    }
-    this->mem->barrier();
+    if(gap_node < 0) return;
+    prof->leave(this->rank, gap_node, tbeg_gap, clock::now());
+    gap_node = -1;
   }
 
-  void start_aux_clock()
+  void gap_beg(const int region)
   {
+    if(prof == nullptr || !prof->top_level(this->rank)) return; // nested hook
+    gap_node = prof->enter(this->rank, region);
+    tbeg_gap = clock::now();
+  }
+
+#if defined(UWLCM_TIMING)
+  clock::time_point tbeg_loop;
+
+  // heap allocations: at the start of the loop, after the first timestep, in record_all (total and until the end of the first timestep)
+  // and in the periodic writes of the status file, which are not part of the timestep
+  unsigned long long allocs_beg, allocs_first, allocs_rec, allocs_rec_first, allocs_status;
+
+  // halo exchanges done in UWLCM code at the start of the loop
+  unsigned long xchng_beg;
+#endif
+
+  protected:
+
+  void hook_ante_loop(int nt) override
+  {
+    // before the loop, so the barrier does not affect timings
+    if(prof != nullptr)
+    {
+      if(this->rank == 0) prof->resize(this->mem->size);
+      this->mem->barrier();
+    }
+
+    {
+      detail::prof_scope_t scope(prof, this->rank, detail::prof_ante_loop);
+      parent_t::hook_ante_loop(nt);
+    }
+
+    // all arrays are allocated, libcloudph++ is initialized
     this->mem->barrier();
-    if (this->rank == 0) 
+    if(this->rank == 0)
     {
-      tbeg_aux = setup::clock::now();
+      detail::mem_ledger().add_other_tmp(this->mem);
+      detail::mem_ledger().mark("init");
+      if(this->mem->distmem.rank() == 0)
+        detail::mem_ledger().print(std::cout);
+      if(status != nullptr) status->begin(nt, this->dt);
     }
     this->mem->barrier();
+
+    gap_beg(detail::prof_between_steps);
+
+#if defined(UWLCM_TIMING)
+    if (this->rank == 0)
+    {
+      tbeg_loop = clock::now();
+      allocs_rec = 0; // only record_all done in loop, not the one in ante_loop
+      allocs_status = 0;
+      allocs_beg = detail::n_heap_allocs();
+      xchng_beg = this->n_xchng;
+    }
+#endif
   }
 
-  void stop_aux_clock(setup::timer &timer)
+  void hook_ante_step() override
   {
-    this->mem->barrier();
-    if (this->rank == 0) 
+    if(prof != nullptr) prof->step(this->rank, this->timestep);
+    gap_end();
     {
-      tend_aux = setup::clock::now();
-      timer += std::chrono::duration_cast<setup::timer>( tend_aux - tbeg_aux );
+      detail::prof_scope_t scope(prof, this->rank, detail::prof_ante_step);
+      parent_t::hook_ante_step();
     }
-    this->mem->barrier();
+    gap_beg(detail::prof_step);
   }
 
-  protected:
-
-  void hook_ante_loop(int nt) override
+  void hook_mixed_rhs_ante_step() override
   {
-    parent_t::hook_ante_loop(nt);
-    this->mem->barrier();
-    if (this->rank == 0) 
-    {   
-      tbeg_loop = setup::clock::now();
-      trecord_all = setup::timer::zero(); // reset to 0, because we only want record all done in loop, not the one in ante_loop 
+    gap_end();
+    {
+      detail::prof_scope_t scope(prof, this->rank, detail::prof_mixed_ante);
+      parent_t::hook_mixed_rhs_ante_step();
     }
-    this->mem->barrier();
+    gap_beg(detail::prof_step);
   }
 
-  void hook_ante_step() override
+  void hook_ante_delayed_step() override
   {
-    get_step_time(thps_has);
-    parent_t::hook_ante_step();
-    get_step_time(thas);
+    gap_end();
+    {
+      detail::prof_scope_t scope(prof, this->rank, detail::prof_ante_delayed);
+      parent_t::hook_ante_delayed_step();
+    }
+    gap_beg(detail::prof_delayed_step);
   }
 
-  void hook_ante_delayed_step() override
+  void hook_mixed_rhs_post_step() override
   {
-    get_step_time(thas_hads);
-    parent_t::hook_ante_delayed_step();
-    get_step_time(thads);
+    gap_end();
+    {
+      detail::prof_scope_t scope(prof, this->rank, detail::prof_mixed_post);
+      parent_t::hook_mixed_rhs_post_step();
+    }
+    gap_beg(detail::prof_delayed_step);
   }
 
   void hook_post_step() override
   {
-    get_step_time(thads_hps);
-    parent_t::hook_post_step();
-    get_step_time(thps);
+    gap_end();
+    {
+      detail::prof_scope_t scope(prof, this->rank, detail::prof_post_step);
+      parent_t::hook_post_step();
+    }
+    gap_beg(detail::prof_between_steps);
 
-    // there's no hook_post_loop, so we imitate it here to write out computation times, TODO: move to destructor?
-    if(this->timestep == nt) // timestep incremented before post_step
+#if defined(UWLCM_TIMING)
+    if (this->rank == 0 && this->timestep == 1)
     {
-      if (this->rank == 0)
-      {
-        tend_loop = setup::clock::now();
-        tloop = std::chrono::duration_cast<setup::timer>( tend_loop - tbeg_loop );
-
-        // calculate CPU/GPU times and concurrency, valid only for async runs and not taking into account diagnostics in record_all
-        setup::timer  tsync_in = parent_t::tsync,
-                      tgpu = parent_t::tasync_wait_in_record_all + parent_t::tsync_wait + parent_t::tasync_wait + tsync_in, // time of pure GPU calculations (= wait time of CPU)
-                      tcpugpu = tsync_in + parent_t::tasync_gpu + parent_t::tsync_gpu - tgpu, // time of concurrent CPU and GPU calculations (= total time of GPU calculations - tgpu)
-                      tcpu = tloop - tgpu - tcpugpu;
-         
-        std::cout <<  "wall time in milliseconds: " << std::endl
-          << "loop:                            " << tloop.count() << std::endl
-          << "  hook_ante_step:                  " << thas.count() << " ("<< setup::real_t(thas.count())/tloop.count()*100 <<"%)" << std::endl
-          << "    hook_mixed_rhs_ante_step:        " << thmas.count() << " ("<< setup::real_t(thmas.count())/tloop.count()*100 <<"%)" << std::endl
-          << "      async_wait:                    " << parent_t::tasync_wait.count() << " ("<< setup::real_t(parent_t::tasync_wait.count())/tloop.count()*100 <<"%)" << std::endl
-          << "      sync:                            " << parent_t::tsync.count() << " ("<< setup::real_t(parent_t::tsync.count())/tloop.count()*100 <<"%)" << std::endl
-          << "  step:                            " << thas_hads.count() << " ("<< setup::real_t(thas_hads.count())/tloop.count()*100 <<"%)" << std::endl
-          << "  hook_ante_delayed_step:          " << thads.count() << " ("<< setup::real_t(thads.count())/tloop.count()*100 <<"%)" << std::endl
-          << "    sync_wait:                       " << parent_t::tsync_wait.count() << " ("<< setup::real_t(parent_t::tsync_wait.count())/tloop.count()*100 <<"%)" << std::endl
-          << "    async:                           " << parent_t::tasync.count() << " ("<< setup::real_t(parent_t::tasync.count())/tloop.count()*100 <<"%)" << std::endl
-          << "  delayed step:                    " << thads_hps.count() << " ("<< setup::real_t(thads_hps.count())/tloop.count()*100 <<"%)" << std::endl
-          << "  hook_post_step:                  " << thps.count() << " ("<< setup::real_t(thps.count())/tloop.count()*100 <<"%)" << std::endl
-          << "    hook_mixed_rhs_post_step:        " << thmps.count() << " ("<< setup::real_t(thmps.count())/tloop.count()*100 <<"%)" << std::endl
-          << "    record_all (in loop):            " << trecord_all.count() << " ("<< setup::real_t(trecord_all.count())/tloop.count()*100 <<"%)" << std::endl
-          << "      async_wait in record_all:      " << parent_t::tasync_wait_in_record_all.count() << " ("<< setup::real_t(parent_t::tasync_wait_in_record_all.count())/tloop.count()*100 <<"%)" << std::endl
-          << "  hook_post_step->hook_ante_step:  " << thps_has.count() << " ("<< setup::real_t(thps_has.count())/tloop.count()*100 <<"%)" << std::endl;
-
-          std::cout << std::endl
-          << "CPU/GPU concurrency stats, only make sense for async lgrngn runs" << std::endl
-          << "and does not take into account GPU time in record_all, so most accurate without diag:" << std::endl
-          << "  pure CPU calculations: " << tcpu.count() << " ("<< setup::real_t(tcpu.count())/tloop.count()*100 <<"%)" << std::endl
-          << "  pure GPU calculations: " << tgpu.count() << " ("<< setup::real_t(tgpu.count())/tloop.count()*100 <<"%)" << std::endl
-          << "  concurrent CPU&GPU:    " << tcpugpu.count() << " ("<< setup::real_t(tcpugpu.count())/tloop.count()*100 <<"%)" << std::endl
-          << "  tsync_gpu:  " << parent_t::tsync_gpu.count() << " ("<< setup::real_t(parent_t::tsync_gpu.count())/tloop.count()*100 <<"%)" << std::endl
-          << "  tasync_gpu: " << parent_t::tasync_gpu.count() << " ("<< setup::real_t(parent_t::tasync_gpu.count())/tloop.count()*100 <<"%)" << std::endl;
-      }
+      allocs_first = detail::n_heap_allocs();
+      allocs_rec_first = allocs_rec;
     }
-  }
 
-  void record_all() override
-  {
-    assert(this->rank == 0);
+    // there's no hook_post_loop, so we imitate it here to write out the statistics
+    // timings of hooks are in the profiler output (--prof)
+    if (this->rank == 0 && this->timestep == nt) // timestep incremented before post_step
+    {
+      const setup::timer tloop = std::chrono::duration_cast<setup::timer>(clock::now() - tbeg_loop);
+
+      // calculate CPU/GPU times and concurrency, valid only for async runs and not taking into account diagnostics in record_all
+      setup::timer  tsync_in = parent_t::tsync,
+                    tgpu = parent_t::tasync_wait_in_record_all + parent_t::tsync_wait + parent_t::tasync_wait + tsync_in, // time of pure GPU calculations (= wait time of CPU)
+                    tcpugpu = tsync_in + parent_t::tasync_gpu + parent_t::tsync_gpu - tgpu, // time of concurrent CPU and GPU calculations (= total time of GPU calculations - tgpu)
+                    tcpu = tloop - tgpu - tcpugpu;
+
+      std::cout << "wall time in milliseconds (thread 0): " << std::endl
+        << "loop:                            " << tloop.count() << std::endl
+        << "  async_wait:                      " << parent_t::tasync_wait.count() << " ("<< setup::real_t(parent_t::tasync_wait.count())/tloop.count()*100 <<"%)" << std::endl
+        << "  sync:                            " << parent_t::tsync.count() << " ("<< setup::real_t(parent_t::tsync.count())/tloop.count()*100 <<"%)" << std::endl
+        << "  sync_wait:                       " << parent_t::tsync_wait.count() << " ("<< setup::real_t(parent_t::tsync_wait.count())/tloop.count()*100 <<"%)" << std::endl
+        << "  async:                           " << parent_t::tasync.count() << " ("<< setup::real_t(parent_t::tasync.count())/tloop.count()*100 <<"%)" << std::endl
+        << "  async_wait in record_all:        " << parent_t::tasync_wait_in_record_all.count() << " ("<< setup::real_t(parent_t::tasync_wait_in_record_all.count())/tloop.count()*100 <<"%)" << std::endl;
+
+      std::cout << std::endl
+        << "CPU/GPU concurrency stats, only make sense for async lgrngn runs" << std::endl
+        << "and does not take into account GPU time in record_all, so most accurate without diag:" << std::endl
+        << "  pure CPU calculations: " << tcpu.count() << " ("<< setup::real_t(tcpu.count())/tloop.count()*100 <<"%)" << std::endl
+        << "  pure GPU calculations: " << tgpu.count() << " ("<< setup::real_t(tgpu.count())/tloop.count()*100 <<"%)" << std::endl
+        << "  concurrent CPU&GPU:    " << tcpugpu.count() << " ("<< setup::real_t(tcpugpu.count())/tloop.count()*100 <<"%)" << std::endl
+        << "  tsync_gpu:  " << parent_t::tsync_gpu.count() << " ("<< setup::real_t(parent_t::tsync_gpu.count())/tloop.count()*100 <<"%)" << std::endl
+        << "  tasync_gpu: " << parent_t::tasync_gpu.count() << " ("<< setup::real_t(parent_t::tasync_gpu.count())/tloop.count()*100 <<"%)" << std::endl;
+
+      // allocations outside of record_all after the first timestep should be zero, checked except for MPI runs and solvers
+      // that allocate in the timestep (lgrngn); other threads may still be in the last timestep
+      const unsigned long long allocs_loop = detail::n_heap_allocs() - allocs_beg,
+                               allocs_step1 = allocs_first - allocs_beg - allocs_rec_first,
+                               allocs_later = allocs_loop - allocs_rec - allocs_status - allocs_step1;
+      std::cout << std::endl
+        << "heap allocations (all threads):" << std::endl
+        << "  loop:                                          " << allocs_loop << std::endl
+        << "    record_all (in loop):                        " << allocs_rec << std::endl
+        << "    status file:                                 " << allocs_status << std::endl
+        << "    first timestep, without record_all:          " << allocs_step1 << std::endl
+        << "    per later timestep, without record_all:      " << (nt > 1 ? setup::real_t(allocs_later) / (nt - 1) : 0) << std::endl;
+      // reported, not enforced: other threads and the trace of the profiler (--trace_from) may allocate in the window
+      if(allocs_later > 0 && this->mem->distmem.size() == 1 && !this->allocs_in_step())
+        std::cout << "  WARNING: " << allocs_later << " heap allocations in timesteps after the first one (without record_all)" << std::endl;
+
+      // exchanges of libmpdata++ (e.g. in advection) are not included
+      const unsigned long xchng_loop = this->n_xchng - xchng_beg;
+      std::cout << std::endl
+        << "halo exchanges in UWLCM code (per thread): " << xchng_loop << " (" << setup::real_t(xchng_loop) / nt << " per timestep)" << std::endl;
+    }
+#endif
 
-    tbeg_aux = setup::clock::now();
-    parent_t::record_all();
-    tend_aux = setup::clock::now();
-    trecord_all = std::chrono::duration_cast<setup::timer>( tend_aux - tbeg_aux );
+    // after the statistics; the "finished" state is written in run() after the loop
+    if(status != nullptr && this->rank == 0)
+    {
+#if defined(UWLCM_TIMING)
+      const unsigned long long allocs = detail::n_heap_allocs();
+#endif
+      status->step(this->timestep);
+#if defined(UWLCM_TIMING)
+      allocs_status += detail::n_heap_allocs() - allocs;
+#endif
+    }
   }
 
-  void hook_mixed_rhs_ante_step() override
+  void record_all() override
   {
-    start_aux_clock();
-    parent_t::hook_mixed_rhs_ante_step();
-    stop_aux_clock(thmas);
-  }
+    assert(this->rank == 0);
 
-  void hook_mixed_rhs_post_step() override
-  {
-    start_aux_clock();
-    parent_t::hook_mixed_rhs_post_step();
-    stop_aux_clock(thmps);
+#if defined(UWLCM_TIMING)
+    const unsigned long long allocs = detail::n_heap_allocs();
+#endif
+    {
+      detail::prof_scope_t scope(prof, this->rank, detail::prof_output);
+      parent_t::record_all();
+    }
+    if(status != nullptr) status->output(this->timestep);
+#if defined(UWLCM_TIMING)
+    allocs_rec += detail::n_heap_allocs() - allocs;
+#endif
   }
 
   public:
 
   // ctor
-  exec_timer( 
-    typename parent_t::ctor_args_t args, 
+  exec_timer(
+    typename parent_t::ctor_args_t args,
     const typename parent_t::rt_params_t &p
-  ) : 
+  ) :
     parent_t(args, p),
-    nt(p.user_params.nt)
-  {}  
+    nt(p.user_params.nt),
+    prof(p.prof != nullptr && p.prof->enabled() ? p.prof : nullptr),
+    status(p.status)
+  {}
 };
@@ -0,0 +1,49 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ */
+
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include "setup.hpp"
+
+#if defined(USE_MPI)
+  #include <boost/mpi/communicator.hpp>
+  #include <boost/mpi/collectives.hpp>
+#endif
+
+namespace detail
+{
+  // buffers for batched horizontal sums of several fields at all levels (see slvr_common::hrzntl_means)
+  // shared among threads of a process, like the profiles
+  struct hrzntl_sums_t
+  {
+    static constexpr int n_fields_max = 12; // max number of fields in one batch
+
+    blitz::Array<double, 2> partial; // per-thread sums, (thread rank, field * nz + level)
+    std::vector<double> total;       // summed over threads (and MPI processes)
+
+    void resize(const int n_threads, const int nz)
+    {
+      partial.resize(n_threads, n_fields_max * nz);
+      total.resize(n_fields_max * nz);
+    }
+  };
+
+  // element-wise sum over all MPI processes, one collective for all elements
+  template<class real_t>
+  inline void distmem_sum(real_t *v, const int n)
+  {
+#if defined(USE_MPI)
+    static thread_local std::vector<real_t> res; // reused, so that there are no allocations per call
+    res.resize(n);
+    boost::mpi::all_reduce(boost::mpi::communicator(), v, n, res.data(), std::plus<real_t>());
+    std::copy(res.begin(), res.end(), v);
+#endif
+  }
+};
@@ -0,0 +1,180 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ */
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <map>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <chrono>
+
+#if defined(USE_MPI)
+  #include <boost/mpi/communicator.hpp>
+  #include <boost/mpi/collectives.hpp>
+  #include <boost/serialization/vector.hpp>
+#endif
+
+namespace detail
+{
+  // memory allocated by the model, attributed to the allocating file and purpose, and process RSS (resident set size)
+  // at stages of the run; one per process, filled by the (single-threaded) allocation and setup code
+  class mem_ledger_t
+  {
+    struct entry_t
+    {
+      std::string file, purpose;
+      unsigned long long bytes;
+    };
+    std::vector<entry_t> entries;
+    std::map<std::string, unsigned long long> tmp_recorded; // bytes of tmp arrays of each file that are already in entries
+
+    struct mark_t
+    {
+      std::string stage;
+      long rss, hwm; // current and peak RSS [kB], -1 if unknown
+      std::chrono::steady_clock::time_point time;
+    };
+    std::vector<mark_t> marks;
+
+    const mark_t &find(const std::string &stage) const
+    {
+      for(const auto &m : marks)
+        if(m.stage == stage) return m;
+      throw std::runtime_error("UWLCM: no memory ledger mark of stage " + stage);
+    }
+
+    static std::string basename(const std::string &file)
+    {
+      return file.substr(file.find_last_of('/') + 1);
+    }
+
+    public:
+
+    // VmRSS or VmHWM from /proc/self/status [kB], -1 if unknown
+    static long proc_status(const std::string &key)
+    {
+      std::ifstream in("/proc/self/status");
+      std::string line;
+      while(std::getline(in, line))
+        if(line.compare(0, key.size() + 1, key + ":") == 0)
+          return std::stol(line.substr(key.size() + 1));
+      return -1;
+    }
+
+    void add(const std::string &file, const std::string &purpose, const unsigned long long bytes)
+    {
+      entries.push_back(entry_t{basename(file), purpose, bytes});
+    }
+
+    // tmp arrays (see alloc_tmp_sclr/alloc_tmp_vctr) of the file allocated since the last call for this file
+    template<class mem_t>
+    void add_tmp(mem_t *mem, const char *file, const std::string &purpose)
+    {
+      unsigned long long bytes = 0;
+      for(auto &vec : mem->tmp[file])
+        for(int i = 0; i < int(vec.size()); ++i)
+          bytes += vec[i].numElements() * sizeof(*vec[i].data());
+      add(file, purpose, bytes - tmp_recorded[file]);
+      tmp_recorded[file] = bytes;
+    }
+
+    // tmp arrays of files that were not recorded with add_tmp (e.g. allocated in libmpdata++)
+    template<class mem_t>
+    void add_other_tmp(mem_t *mem)
+    {
+      for(auto &kv : mem->tmp)
+      {
+        if(tmp_recorded.count(kv.first) > 0) continue;
+        unsigned long long bytes = 0;
+        for(auto &vec : kv.second)
+          for(int i = 0; i < int(vec.size()); ++i)
+            bytes += vec[i].numElements() * sizeof(*vec[i].data());
+        add(kv.first, "tmp arrays", bytes);
+        tmp_recorded[kv.first] = bytes;
+      }
+    }
+
+    void mark(const std::string &stage)
+    {
+      marks.push_back(mark_t{stage, proc_status("VmRSS"), proc_status("VmHWM"), std::chrono::steady_clock::now()});
+    }
+
+    // wall time between two stages [s]
+    double seconds(const std::string &from, const std::string &to) const
+    {
+      return std::chrono::duration<double>(find(to).time - find(from).time).count();
+    }
+
+    // peak RSS at the stage [kB], -1 if unknown
+    long peak_rss(const std::string &stage) const
+    {
+      return find(stage).hwm;
+    }
+
+    unsigned long long total() const
+    {
+      unsigned long long res = 0;
+      for(const auto &e : entries) res += e.bytes;
+      return res;
+    }
+
+    void print(std::ostream &os, const std::string &title = "memory allocated by UWLCM per process [MB]") const
+    {
+      os << title << ": " << total() / 1e6 << std::endl;
+      for(const auto &e : entries)
+        os << "  " << e.file << ": " << e.purpose << ": " << e.bytes / 1e6 << std::endl;
+      for(const auto &m : marks)
+        os << "  RSS at " << m.stage << ": " << m.rss / 1e3 << ", peak: " << m.hwm / 1e3 << std::endl;
+    }
+
+    // JSON with the ledger of this process and RSS of all processes; collective in MPI runs, written by process 0
+    void write(const std::string &file) const
+    {
+      std::vector<long> rss;
+      for(const auto &m : marks) rss.insert(rss.end(), {m.rss, m.hwm});
+
+      std::vector<std::vector<long>> all(1, rss);
+#if defined(USE_MPI)
+      boost::mpi::communicator world;
+      boost::mpi::gather(world, rss, all, 0);
+      if(world.rank() != 0) return;
+#endif
+
+      std::ofstream out(file);
+      if(!out.good()) throw std::runtime_error("UWLCM: could not open the memory ledger output file " + file);
+
+      out << "{\n"
+          << "  \"unit\": \"B\",\n"
+          << "  \"total\": " << total() << ",\n"
+          << "  \"entries\": [";
+      for(std::size_t i = 0; i < entries.size(); ++i)
+        out << (i == 0 ? "\n" : ",\n")
+            << "    {\"file\": \"" << entries[i].file << "\", \"purpose\": \"" << entries[i].purpose << "\", \"bytes\": " << entries[i].bytes << "}";
+      // [RSS, peak RSS] of each process at each stage [kB]
+      out << "\n  ],\n"
+          << "  \"rss_kB\": [";
+      for(std::size_t i = 0; i < marks.size(); ++i)
+      {
+        out << (i == 0 ? "\n" : ",\n")
+            << "    {\"stage\": \"" << marks[i].stage << "\", \"processes\": [";
+        for(std::size_t p = 0; p < all.size(); ++p)
+          out << (p == 0 ? "" : ", ") << "[" << all[p].at(2 * i) << ", " << all[p].at(2 * i + 1) << "]";
+        out << "]}";
+      }
+      out << "\n  ]\n}\n";
+    }
+  };
+
+  inline mem_ledger_t &mem_ledger()
+  {
+    static mem_ledger_t ledger;
+    return ledger;
+  }
+};
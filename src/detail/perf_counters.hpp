@@ -0,0 +1,115 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__linux__)
+  #include <cerrno>
+  #include <unistd.h>
+  #include <sys/ioctl.h>
+  #include <sys/syscall.h>
+  #include <linux/perf_event.h>
+#endif
+
+namespace detail
+{
+  // hardware counters of the calling thread (Linux perf_event_open), read together as a group;
+  // may be unavailable, e.g. in containers, VMs or with kernel.perf_event_paranoid > 2
+  class perf_counters_t
+  {
+    public:
+
+    enum { cycles, instructions, cache_refs, cache_misses, n_counters };
+
+    private:
+
+    int fds[n_counters];
+    bool ok = false;
+
+    public:
+
+    std::string error; // why the counters are unavailable
+
+    perf_counters_t() { for(auto &fd : fds) fd = -1; }
+
+    ~perf_counters_t() { close(); }
+
+    perf_counters_t(const perf_counters_t&) = delete;
+    perf_counters_t& operator=(const perf_counters_t&) = delete;
+
+    bool available() const { return ok; }
+
+    // has to be called by the thread that is counted
+    bool open()
+    {
+#if defined(__linux__)
+      const std::uint64_t configs[n_counters] = {
+        PERF_COUNT_HW_CPU_CYCLES,
+        PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_REFERENCES,
+        PERF_COUNT_HW_CACHE_MISSES
+      };
+      for(int c = 0; c < n_counters; ++c)
+      {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = configs[c];
+        attr.read_format = PERF_FORMAT_GROUP;
+        attr.disabled = c == 0; // the group is enabled by its leader
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fds[c] = syscall(__NR_perf_event_open, &attr, 0, -1, c == 0 ? -1 : fds[0], 0); // this thread, any CPU
+        if(fds[c] < 0)
+        {
+          error = "perf_event_open failed: " + std::string(std::strerror(errno));
+          close();
+          return false;
+        }
+      }
+      ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+      ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+      ok = true;
+      return true;
+#else
+      error = "hardware counters are supported only on Linux";
+      return false;
+#endif
+    }
+
+    // current values, one system call
+    bool read(std::uint64_t (&vals)[n_counters]) const
+    {
+#if defined(__linux__)
+      if(!ok) return false;
+      std::uint64_t buf[1 + n_counters]; // number of counters followed by their values
+      if(::read(fds[0], buf, sizeof(buf)) != sizeof(buf)) return false;
+      for(int c = 0; c < n_counters; ++c) vals[c] = buf[1 + c];
+      return true;
+#else
+      return false;
+#endif
+    }
+
+    void close()
+    {
+#if defined(__linux__)
+      for(auto &fd : fds)
+      {
+        if(fd >= 0) ::close(fd);
+        fd = -1;
+      }
+#endif
+      ok = false;
+    }
+  };
+};
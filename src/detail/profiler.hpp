@@ -0,0 +1,521 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ */
+
+#pragma once
+
+#include <vector>
+#include <string>
+#include <map>
+#include <set>
+#include <sstream>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <algorithm>
+#include <stdexcept>
+#include <iostream>
+#include <memory>
+#include "perf_counters.hpp"
+
+#if defined(USE_MPI)
+  #include <boost/mpi/communicator.hpp>
+  #include <boost/mpi/collectives.hpp>
+  #include <boost/serialization/vector.hpp>
+  #include <boost/serialization/string.hpp>
+#endif
+
+namespace detail
+{
+  // regions timed by the profiler; their hierarchy is given by the nesting of scopes at runtime,
+  // e.g. SGS viscosity computed in libmpdata++ advection is step/sgs
+  enum prof_region_t
+  {
+    prof_ante_loop,      // hook_ante_loop
+    prof_ante_step,      // hook_ante_step
+    prof_mixed_ante,     // hook_mixed_rhs_ante_step
+    prof_step,           // from the end of hook_ante_step to hook_ante_delayed_step (advection and pressure solver in libmpdata++)
+    prof_ante_delayed,   // hook_ante_delayed_step
+    prof_delayed_step,   // from the end of hook_ante_delayed_step to hook_post_step (advection of delayed advectees in libmpdata++)
+    prof_post_step,      // hook_post_step
+    prof_mixed_post,     // hook_mixed_rhs_post_step
+    prof_between_steps,  // from the end of hook_post_step to hook_ante_step of the next timestep
+    prof_output,         // record_all
+    prof_forcings,       // slvr_common::update_rhs
+    prof_sgs,            // SGS viscosity and fluxes
+    prof_micro,          // microphysics
+    prof_xchng,          // halo exchanges done in UWLCM code
+    prof_async_wait,     // waiting for asynchronous microphysics (lgrngn)
+    prof_n_regions
+  };
+
+  const char * const prof_region_names[prof_n_regions] = {
+    "hook_ante_loop",
+    "hook_ante_step",
+    "hook_mixed_rhs_ante_step",
+    "step",
+    "hook_ante_delayed_step",
+    "delayed_step",
+    "hook_post_step",
+    "hook_mixed_rhs_post_step",
+    "between_steps",
+    "output",
+    "forcings",
+    "sgs",
+    "microphysics",
+    "halo_exchange",
+    "async_wait"
+  };
+
+  // per-thread inclusive times of (nested) code regions; each thread writes only to its own tree, so there is no
+  // synchronization in the timed code, results are aggregated over threads and MPI processes in write()
+  class profiler_t
+  {
+    public:
+
+    using clock = std::chrono::steady_clock;
+
+    private:
+
+    static constexpr int key_base = 32; // > prof_n_regions
+
+    struct node_t
+    {
+      double key;          // identifies the path from the root: key of the parent * key_base + region + 1
+      int parent;          // index of the parent node, -1 for top-level regions
+      int region;
+      unsigned long calls;
+      double time;         // [s]
+      std::uint64_t cnt[perf_counters_t::n_counters],     // hardware counters
+                    cnt_beg[perf_counters_t::n_counters]; // at enter()
+    };
+
+    // barrier of UWLCM code, distinguished by its site and the site of the previous barrier of the thread
+    struct barrier_t
+    {
+      const char *site, *prev;
+      double key;          // of the region in which the barrier is
+      unsigned long calls;
+      double wait,         // [s] in the barrier
+             work;         // [s] from leaving the previous barrier to arriving at this one
+    };
+
+    // complete event of the trace
+    struct event_t
+    {
+      const char *name;
+      bool barrier;
+      double beg, dur; // [us]
+    };
+
+    struct thread_t
+    {
+      std::vector<node_t> nodes;
+      int cur = -1;        // innermost open scope
+      std::vector<barrier_t> barriers;
+      const char *last_site = nullptr;
+      clock::time_point tend_last;
+      std::unique_ptr<perf_counters_t> counters; // opened at the first enter() of the thread
+      bool tracing = false;                      // in the window of traced timesteps
+      std::vector<event_t> events;
+      char pad[64];        // threads write to neighbouring elements, avoid false sharing
+    };
+
+    const bool on, count;
+    const int trace_beg, trace_end; // window of traced timesteps, trace_beg < 0 if there is no tracing
+    const clock::time_point t0;     // origin of the trace
+    const std::chrono::system_clock::time_point sys_t0; // t0 on the system clock, common to all processes
+    std::vector<thread_t> threads;
+
+    static double us(const clock::duration &d) { return std::chrono::duration<double, std::micro>(d).count(); }
+
+    void read_counters(thread_t &t, std::uint64_t (&vals)[perf_counters_t::n_counters])
+    {
+      if(!t.counters)
+      {
+        t.counters.reset(new perf_counters_t());
+        t.counters->open();
+      }
+      if(!t.counters->read(vals))
+        for(auto &v : vals) v = 0;
+    }
+
+    // statistics over threads
+    struct stats_t
+    {
+      int n = 0;
+      unsigned long calls = 0;
+      double min = 0, max = 0, sum = 0;
+      void add(const unsigned long c, const double t)
+      {
+        min = n == 0 ? t : std::min(min, t);
+        max = n == 0 ? t : std::max(max, t);
+        sum += t;
+        calls = std::max(calls, c);
+        n += 1;
+      }
+      double mean() const { return sum / n; }
+    };
+    using thread_id_t = std::pair<int, int>; // process, thread
+    struct bstats_t { std::string name, path; stats_t wait, work; thread_id_t slowest; };
+
+    static bool longer_wait(const bstats_t *a, const bstats_t *b) { return a->wait.mean() > b->wait.mean(); }
+
+    // sums of counters over threads and derived rates, empty if counters are unavailable
+    static std::string counter_stats(const std::map<std::string, std::vector<double>> &cnt_sums, const std::string &p)
+    {
+      const auto it = cnt_sums.find(p);
+      if(it == cnt_sums.end()) return "";
+      const std::vector<double> &cs = it->second;
+      std::ostringstream res;
+      res.precision(9);
+      res << ", \"cycles\": " << cs[perf_counters_t::cycles]
+          << ", \"instructions\": " << cs[perf_counters_t::instructions]
+          << ", \"cache_refs\": " << cs[perf_counters_t::cache_refs]
+          << ", \"cache_misses\": " << cs[perf_counters_t::cache_misses]
+          << ", \"ipc\": " << (cs[perf_counters_t::cycles] > 0 ? cs[perf_counters_t::instructions] / cs[perf_counters_t::cycles] : 0)
+          << ", \"cache_miss_ratio\": " << (cs[perf_counters_t::cache_refs] > 0 ? cs[perf_counters_t::cache_misses] / cs[perf_counters_t::cache_refs] : 0)
+          // estimate of the memory bandwidth: 64 B per last-level cache miss, summed over threads, divided by the total time of the threads
+          << ", \"miss_GBps_per_thread\": " << (cs.back() > 0 ? cs[perf_counters_t::cache_misses] * 64 / cs.back() / 1e9 : 0);
+      return res.str();
+    }
+
+    static std::string path(double key)
+    {
+      std::string res;
+      while(key > 0)
+      {
+        const int d = std::fmod(key, key_base);
+        res = prof_region_names[d - 1] + (res.empty() ? "" : "/" + res);
+        key = (key - d) / key_base;
+      }
+      return res;
+    }
+
+    public:
+
+    // on: timings of regions, count: also hardware counters of the regions (see perf_counters_t),
+    // trace_beg/end: events of timesteps from trace_beg to trace_end are recorded for write_trace()
+    profiler_t(const bool on, const bool count = false, const int trace_beg = -1, const int trace_end = -1) :
+      on(on || trace_beg >= 0),
+      count(on && count),
+      trace_beg(trace_beg),
+      trace_end(trace_end),
+      t0(clock::now()),
+      sys_t0(std::chrono::system_clock::now())
+    {
+      if(trace_beg >= 0 && trace_end < trace_beg)
+        throw std::runtime_error("UWLCM: the last traced timestep is before the first one");
+    }
+
+    bool enabled() const { return on; }
+    bool tracing() const { return trace_beg >= 0; }
+
+    // called by each thread at the start of a timestep
+    void step(const int th, const int timestep)
+    {
+      threads[th].tracing = timestep >= trace_beg && timestep <= trace_end && tracing();
+    }
+
+    // has to be called before the threads start timing
+    void resize(const int n_threads)
+    {
+      threads.resize(n_threads);
+      // so that timesteps after the first one do not allocate (apart from the events of the trace)
+      for(auto &t : threads)
+      {
+        t.nodes.reserve(4 * prof_n_regions);
+        t.barriers.reserve(64);
+      }
+    }
+
+    bool top_level(const int th) const { return threads[th].cur < 0; }
+
+    // opens a scope of the region in thread th, returns its node
+    int enter(const int th, const int region)
+    {
+      thread_t &t = threads[th];
+      int n = 0;
+      while(n < int(t.nodes.size()) && !(t.nodes[n].parent == t.cur && t.nodes[n].region == region)) ++n;
+      if(n == int(t.nodes.size()))
+      {
+        const double key = (t.cur < 0 ? 0 : t.nodes[t.cur].key) * key_base + region + 1;
+        t.nodes.push_back(node_t{key, t.cur, region, 0, 0, {0}, {0}});
+      }
+      if(count) read_counters(t, t.nodes[n].cnt_beg);
+      return t.cur = n;
+    }
+
+    void leave(const int th, const int node, const clock::time_point &tbeg, const clock::time_point &tend)
+    {
+      thread_t &t = threads[th];
+      t.nodes[node].calls += 1;
+      t.nodes[node].time += std::chrono::duration<double>(tend - tbeg).count();
+      if(t.tracing)
+        t.events.push_back(event_t{prof_region_names[t.nodes[node].region], false, us(tbeg - t0), us(tend - tbeg)});
+      t.cur = t.nodes[node].parent;
+      if(count)
+      {
+        std::uint64_t vals[perf_counters_t::n_counters];
+        read_counters(t, vals);
+        for(int c = 0; c < perf_counters_t::n_counters; ++c)
+          t.nodes[node].cnt[c] += vals[c] - t.nodes[node].cnt_beg[c];
+      }
+    }
+
+    // arrival at and departure from a barrier of thread th
+    void barrier(const int th, const char *site, const clock::time_point &tarr, const clock::time_point &tdep)
+    {
+      if(th >= int(threads.size())) return; // before resize()
+      thread_t &t = threads[th];
+      barrier_t *b = nullptr;
+      for(auto &e : t.barriers)
+        if(e.site == site && e.prev == t.last_site) {b = &e; break;}
+      if(b == nullptr)
+      {
+        t.barriers.push_back(barrier_t{site, t.last_site, t.cur < 0 ? 0 : t.nodes[t.cur].key, 0, 0, 0});
+        b = &t.barriers.back();
+      }
+      b->calls += 1;
+      b->wait += std::chrono::duration<double>(tdep - tarr).count();
+      if(t.last_site != nullptr)
+        b->work += std::chrono::duration<double>(tarr - t.tend_last).count();
+      t.last_site = site;
+      t.tend_last = tdep;
+      if(t.tracing)
+        t.events.push_back(event_t{site, true, us(tarr - t0), us(tdep - tarr)});
+    }
+
+    // JSON with times of each thread and their min/mean/max over all threads of all processes, and the barrier
+    // imbalance report; collective in MPI runs, written by process 0; completed = false for runs stopped with the panic flag
+    void write(const std::string &file, const int nt, const bool completed) const
+    {
+      // records of regions (key, process, thread, calls, time, hardware counters or -1 if unavailable)
+      // and of barriers (key, process, thread, calls, wait, work)
+      const int nc = perf_counters_t::n_counters, nr = 5 + nc;
+      std::vector<double> recs, brecs;
+      std::vector<std::string> bnames; // "previous site -> site"
+      int rank = 0, size = 1;
+#if defined(USE_MPI)
+      boost::mpi::communicator world;
+      rank = world.rank();
+      size = world.size();
+#endif
+      for(int th = 0; th < int(threads.size()); ++th)
+      {
+        const bool cnt_ok = count && threads[th].counters && threads[th].counters->available();
+        for(const auto &n : threads[th].nodes)
+        {
+          recs.insert(recs.end(), {n.key, double(rank), double(th), double(n.calls), n.time});
+          for(int c = 0; c < nc; ++c) recs.push_back(cnt_ok ? double(n.cnt[c]) : -1);
+        }
+        for(const auto &b : threads[th].barriers)
+        {
+          brecs.insert(brecs.end(), {b.key, double(rank), double(th), double(b.calls), b.wait, b.work});
+          bnames.push_back(std::string(b.prev == nullptr ? "start" : b.prev) + " -> " + b.site);
+        }
+      }
+
+#if defined(USE_MPI)
+      std::vector<std::vector<double>> all, ball;
+      std::vector<std::vector<std::string>> bnall;
+      boost::mpi::gather(world, recs, all, 0);
+      boost::mpi::gather(world, brecs, ball, 0);
+      boost::mpi::gather(world, bnames, bnall, 0);
+      if(rank != 0) return;
+      recs.clear();
+      brecs.clear();
+      bnames.clear();
+      for(const auto &r : all) recs.insert(recs.end(), r.begin(), r.end());
+      for(const auto &r : ball) brecs.insert(brecs.end(), r.begin(), r.end());
+      for(const auto &r : bnall) bnames.insert(bnames.end(), r.begin(), r.end());
+#endif
+
+      std::ofstream out(file);
+      if(!out.good()) throw std::runtime_error("UWLCM: could not open the profiler output file " + file);
+      out.precision(9);
+
+      std::map<std::string, stats_t> stats;
+      std::map<std::string, std::vector<double>> cnt_sums; // counters and time summed over threads with counters
+      std::map<thread_id_t, std::map<std::string, std::vector<double>>> per_thread, per_thread_b;
+      std::set<thread_id_t> cnt_threads;
+
+      for(std::size_t r = 0; r < recs.size(); r += nr)
+      {
+        const std::string p = path(recs[r]);
+        const thread_id_t id(recs[r + 1], recs[r + 2]);
+        std::vector<double> &pt = per_thread[id][p];
+        pt.assign({recs[r + 3], recs[r + 4]});
+        stats[p].add(recs[r + 3], recs[r + 4]);
+        if(recs[r + 5] < 0) continue;
+        cnt_threads.insert(id);
+        std::vector<double> &cs = cnt_sums[p];
+        cs.resize(nc + 1, 0);
+        for(int c = 0; c < nc; ++c)
+        {
+          pt.push_back(recs[r + 5 + c]);
+          cs[c] += recs[r + 5 + c];
+        }
+        cs[nc] += recs[r + 4];
+      }
+
+      // barriers, the thread that worked longest since the previous barrier is the one the others wait for
+      std::map<std::pair<std::string, std::string>, bstats_t> bstats;
+      for(std::size_t r = 0; r < brecs.size(); r += 6)
+      {
+        const std::string p = path(brecs[r]), &name = bnames[r / 6];
+        const thread_id_t id(brecs[r + 1], brecs[r + 2]);
+        per_thread_b[id][name + " (" + p + ")"] = {brecs[r + 3], brecs[r + 4], brecs[r + 5]};
+        bstats_t &b = bstats[{name, p}];
+        b.name = name;
+        b.path = p;
+        if(b.work.n == 0 || brecs[r + 5] > b.work.max) b.slowest = id;
+        b.wait.add(brecs[r + 3], brecs[r + 4]);
+        b.work.add(brecs[r + 3], brecs[r + 5]);
+      }
+      std::vector<const bstats_t*> imbalance;
+      for(const auto &b : bstats) imbalance.push_back(&b.second);
+      std::sort(imbalance.begin(), imbalance.end(), longer_wait);
+
+      out << "{\n"
+          << "  \"clock\": \"steady_clock\",\n"
+          << "  \"unit\": \"s\",\n"
+          << "  \"nt\": " << nt << ",\n"
+          << "  \"completed\": " << (completed ? "true" : "false") << ",\n"
+          << "  \"mpi_processes\": " << size << ",\n"
+          << "  \"threads\": " << per_thread.size() << ",\n"
+          << "  \"counters\": {\"requested\": " << (count ? "true" : "false") << ", \"threads\": " << cnt_threads.size()
+          << ", \"error\": \"" << (count && !threads.empty() && threads[0].counters ? threads[0].counters->error : "") << "\"},\n"
+          << "  \"regions\": [";
+      // inclusive times, paths of nested regions follow their parents
+      for(auto it = stats.begin(); it != stats.end(); ++it)
+        out << (it == stats.begin() ? "\n" : ",\n")
+            << "    {\"path\": \"" << it->first << "\", \"threads\": " << it->second.n << ", \"calls\": " << it->second.calls
+            << ", \"min\": " << it->second.min << ", \"mean\": " << it->second.mean() << ", \"max\": " << it->second.max
+            << counter_stats(cnt_sums, it->first) << "}";
+      // barriers of UWLCM code by mean wait time; work is the time from leaving the previous barrier,
+      // the slowest thread is the one with the longest work, i.e. the one the others wait for
+      out << "\n  ],\n"
+          << "  \"barriers\": [";
+      for(auto it = imbalance.begin(); it != imbalance.end(); ++it)
+        out << (it == imbalance.begin() ? "\n" : ",\n")
+            << "    {\"barrier\": \"" << (*it)->name << "\", \"path\": \"" << (*it)->path << "\", \"threads\": " << (*it)->wait.n << ", \"calls\": " << (*it)->wait.calls
+            << ", \"wait\": {\"min\": " << (*it)->wait.min << ", \"mean\": " << (*it)->wait.mean() << ", \"max\": " << (*it)->wait.max << "}"
+            << ", \"work\": {\"min\": " << (*it)->work.min << ", \"mean\": " << (*it)->work.mean() << ", \"max\": " << (*it)->work.max << "}"
+            << ", \"slowest\": {\"process\": " << (*it)->slowest.first << ", \"thread\": " << (*it)->slowest.second << "}}";
+      // [calls, time(, cycles, instructions, cache references, cache misses)] of each region and [calls, wait, work] of each barrier
+      out << "\n  ],\n"
+          << "  \"per_thread\": [";
+      for(auto it = per_thread.begin(); it != per_thread.end(); ++it)
+      {
+        out << (it == per_thread.begin() ? "\n" : ",\n")
+            << "    {\"process\": " << it->first.first << ", \"thread\": " << it->first.second << ", \"regions\": {";
+        for(auto jt = it->second.begin(); jt != it->second.end(); ++jt)
+        {
+          out << (jt == it->second.begin() ? "" : ", ") << "\"" << jt->first << "\": [";
+          for(std::size_t v = 0; v < jt->second.size(); ++v) out << (v == 0 ? "" : ", ") << jt->second[v];
+          out << "]";
+        }
+        out << "}, \"barriers\": {";
+        const auto &bs = per_thread_b[it->first];
+        for(auto jt = bs.begin(); jt != bs.end(); ++jt)
+          out << (jt == bs.begin() ? "" : ", ") << "\"" << jt->first << "\": [" << jt->second[0] << ", " << jt->second[1] << ", " << jt->second[2] << "]";
+        out << "}}";
+      }
+      out << "\n  ]\n}\n";
+
+      // short imbalance report
+      if(!imbalance.empty())
+      {
+        std::cout << "barriers with the longest mean wait (see " << file << "):" << std::endl;
+        for(int i = 0; i < std::min<int>(5, imbalance.size()); ++i)
+          std::cout << "  " << imbalance[i]->name << " (in " << imbalance[i]->path << "): mean wait " << imbalance[i]->wait.mean() << " s, "
+                    << "slowest: process " << imbalance[i]->slowest.first << " thread " << imbalance[i]->slowest.second
+                    << " with " << imbalance[i]->work.max << " s from the previous barrier (mean " << imbalance[i]->work.mean() << " s)" << std::endl;
+      }
+    }
+
+    // Chrome trace (JSON array format, e.g. for chrome://tracing or Perfetto) of the traced timesteps,
+    // one process per MPI process and one thread per thread; collective in MPI runs, written by process 0
+    void write_trace(const std::string &file) const
+    {
+      // records of (process, thread, barrier, begin, duration) and names of events
+      std::vector<double> recs;
+      std::vector<std::string> names;
+      int rank = 0;
+      // times of the events are relative to t0 of this process, shifted to t0 of process 0 with the system clock
+      // (steady clocks of different processes have no common origin)
+      double shift = 0;
+#if defined(USE_MPI)
+      boost::mpi::communicator world;
+      rank = world.rank();
+      const double sys_t0_us = std::chrono::duration<double, std::micro>(sys_t0.time_since_epoch()).count();
+      double sys_t0_us_0 = sys_t0_us;
+      boost::mpi::broadcast(world, sys_t0_us_0, 0);
+      shift = sys_t0_us - sys_t0_us_0;
+#endif
+      for(int th = 0; th < int(threads.size()); ++th)
+        for(const auto &e : threads[th].events)
+        {
+          recs.insert(recs.end(), {double(rank), double(th), double(e.barrier), e.beg + shift, e.dur});
+          names.push_back(e.name);
+        }
+
+#if defined(USE_MPI)
+      std::vector<std::vector<double>> all;
+      std::vector<std::vector<std::string>> nall;
+      boost::mpi::gather(world, recs, all, 0);
+      boost::mpi::gather(world, names, nall, 0);
+      if(rank != 0) return;
+      recs.clear();
+      names.clear();
+      for(const auto &r : all) recs.insert(recs.end(), r.begin(), r.end());
+      for(const auto &r : nall) names.insert(names.end(), r.begin(), r.end());
+#endif
+
+      std::ofstream out(file);
+      if(!out.good()) throw std::runtime_error("UWLCM: could not open the trace output file " + file);
+      out.precision(15);
+
+      // times are relative to the creation of the profiler in process 0
+      out << "[";
+      for(std::size_t r = 0; r < recs.size(); r += 5)
+        out << (r == 0 ? "\n" : ",\n")
+            << "{\"name\": \"" << names[r / 5] << "\", \"cat\": \"" << (recs[r + 2] > 0 ? "barrier" : "region") << "\", \"ph\": \"X\""
+            << ", \"ts\": " << recs[r + 3] << ", \"dur\": " << recs[r + 4] << ", \"pid\": " << recs[r] << ", \"tid\": " << recs[r + 1] << "}";
+      out << "\n]\n";
+    }
+  };
+
+  // times the enclosing block as a region of thread th, nothing is done if the profiler is off
+  class prof_scope_t
+  {
+    profiler_t *prof;
+    const int th;
+    int node;
+    profiler_t::clock::time_point tbeg;
+
+    public:
+
+    prof_scope_t(profiler_t *prof, const int th, const int region) :
+      prof(prof != nullptr && prof->enabled() ? prof : nullptr),
+      th(th)
+    {
+      if(this->prof == nullptr) return;
+      node = this->prof->enter(th, region);
+      tbeg = profiler_t::clock::now();
+    }
+
+    ~prof_scope_t()
+    {
+      if(prof == nullptr) return;
+      prof->leave(th, node, tbeg, profiler_t::clock::now());
+    }
+
+    prof_scope_t(const prof_scope_t&) = delete;
+    prof_scope_t& operator=(const prof_scope_t&) = delete;
+  };
+};
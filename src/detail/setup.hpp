@@ -9,7 +9,7 @@ namespace setup
 {
   using arr_1D_t = blitz::Array<setup::real_t, 1>;
 
-  using clock = std::chrono::system_clock;
+  using clock = std::chrono::steady_clock;
   using timer = std::chrono::milliseconds;
 
   const int mean_horvel_npts = 1e5; // number of iterations when calculating mean horizontal velocities (done only at the start of a simulation)
@@ -0,0 +1,134 @@
+/**
+ * @file
+ * @copyright University of Warsaw
+ * @section LICENSE
+ * GPLv3+ (see the COPYING file or http://www.gnu.org/licenses/)
+ */
+
+#pragma once
+
+#include <string>
+#include <fstream>
+#include <chrono>
+#include <cstdio> // std::rename
+#include <stdexcept>
+
+#include "mem_ledger.hpp"
+
+#if defined(USE_MPI)
+  #include <boost/mpi/communicator.hpp>
+#endif
+
+namespace detail
+{
+  // progress of the run (timestep, steps per second, ETA, RSS, super-droplets and the last output) in a JSON file
+  // rewritten at most every interval seconds; filled by thread 0 of process 0, the other processes do nothing
+  class status_t
+  {
+    using clock = std::chrono::steady_clock;
+
+    const std::string file;
+    const double interval; // [s], writing is off if not positive
+    bool on;
+
+    int nt = 0;
+    double dt = 0;
+    clock::time_point t0, t_last; // start of the loop and the last write
+    int step_last = 0;            // timestep at the last write
+    int step_cur = 0;             // the last completed timestep
+    int step_out = -1;            // timestep of the last output
+    double sec_out = -1;          // wall time of the last output from the start of the loop [s]
+    double n_sd = -1;             // number of super-droplets (of all processes) at the last output, -1 if not lgrngn
+
+    double sec(const clock::time_point &t) const { return std::chrono::duration<double>(t - t0).count(); }
+
+    void write(const int timestep, const clock::time_point &now, const std::string &state)
+    {
+      const double sec_now = sec(now),
+                   sec_recent = std::chrono::duration<double>(now - t_last).count(),
+                   sps = sec_now > 0 ? timestep / sec_now : 0,
+                   sps_recent = sec_recent > 0 ? (timestep - step_last) / sec_recent : sps;
+
+      // written to a temporary file and renamed, so that readers never see a partial file
+      const std::string tmp = file + ".tmp";
+      {
+        std::ofstream out(tmp);
+        if(!out.good()) throw std::runtime_error("UWLCM: could not open the status file " + tmp);
+        out << "{\n"
+            << "  \"state\": \"" << state << "\",\n"
+            << "  \"timestep\": " << timestep << ",\n"
+            << "  \"nt\": " << nt << ",\n"
+            << "  \"simulated_time_s\": " << timestep * dt << ",\n"
+            << "  \"wall_time_s\": " << sec_now << ",\n"
+            << "  \"steps_per_s\": {\"recent\": " << sps_recent << ", \"average\": " << sps << "},\n"
+            << "  \"eta_s\": " << (sps_recent > 0 ? (nt - timestep) / sps_recent : -1) << ",\n"
+            << "  \"rss_kB\": " << mem_ledger_t::proc_status("VmRSS") << ",\n"
+            << "  \"peak_rss_kB\": " << mem_ledger_t::proc_status("VmHWM") << ",\n"
+            << "  \"super_droplets\": " << n_sd << ",\n"
+            << "  \"last_output\": {\"timestep\": " << step_out << ", \"wall_time_s\": " << sec_out << "}\n"
+            << "}\n";
+      }
+      std::rename(tmp.c_str(), file.c_str());
+
+      t_last = now;
+      step_last = timestep;
+    }
+
+    public:
+
+    status_t(const std::string &file, const double interval) :
+      file(file), interval(interval), on(interval > 0)
+    {
+#if defined(USE_MPI)
+      if(boost::mpi::communicator().rank() != 0) on = false;
+#endif
+    }
+
+    // start of the timestepping loop
+    void begin(const int nt_, const double dt_)
+    {
+      if(!on) return;
+      nt = nt_;
+      dt = dt_;
+      t0 = t_last = clock::now();
+      if(step_out == 0) sec_out = 0; // initial output, done before the loop
+      write(0, t0, "running");
+    }
+
+    // end of a timestep, writes if the interval has passed since the last write; one clock read otherwise
+    void step(const int timestep)
+    {
+      if(!on) return;
+      step_cur = timestep;
+      const clock::time_point now = clock::now();
+      if(std::chrono::duration<double>(now - t_last).count() >= interval)
+        write(timestep, now, "running");
+    }
+
+    void output(const int timestep)
+    {
+      if(!on) return;
+      step_out = timestep;
+      sec_out = sec(clock::now());
+    }
+
+    void super_droplets(const double n)
+    {
+      n_sd = n;
+    }
+
+    // after the loop of a completed run
+    void finished()
+    {
+      if(!on) return;
+      write(step_cur, clock::now(), "finished");
+    }
+
+    // after the loop of a run stopped with the panic flag
+    void stopped()
+    {
+      if(!on) return;
+      write(step_cur, clock::now(), "stopped");
+    }
+  };
+};
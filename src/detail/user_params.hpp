@@ -7,9 +7,12 @@
 // note: description and default values are in uwlcm.cpp, all parameters have to be handled there
 struct user_params_t
 {
-  int nt, outfreq, outstart, outwindow, spinup, rng_seed, rng_seed_init;
+  int nt, outfreq, outstart, outwindow, spinup, rng_seed, rng_seed_init,
+      trace_from, trace_to, // window of timesteps traced by the profiler
+      estimate_procs, estimate_steps,
+      status_interval; // [s]
   setup::real_t X, Y, Z, dt;
-  std::string outdir, model_case;
+  std::string outdir, model_case, sounding_file;
   setup::real_t sgs_delta;
   quantity<si::length, setup::real_t> mean_rd1, mean_rd2;		
   quantity<si::dimensionless, setup::real_t> sdev_rd1, sdev_rd2;		
@@ -20,5 +23,9 @@ struct user_params_t
 
   bool relax_th_rv,
        window,
+       reuse_buoyancy,
+       prof,
+       prof_counters,
+       estimate,
        relax_ccn = false; // relevant only for lgrngn micro, hence needs a default value as otherwise it might be undefined in blk_1m/blk_2m
 };
@@ -2,22 +2,23 @@
 
 // TODO: rv_LS and th_LS are very similar, make one function
 
+// large-scale horizontal advection, added to the per-level sum of sources
 template <class ct_params_t>
-void slvr_common<ct_params_t>::rv_LS()
+void slvr_common<ct_params_t>::rv_LS(setup::arr_1D_t &lvl_src)
 {
   params.update_rv_LS(
     *params.rv_LS, this->timestep, params.dt, params.dz
   );
 
-  F(this->ijk).reindex(this->zero) = (*params.rv_LS)(this->vert_idx);
+  lvl_src += *params.rv_LS;
 }
 
 template <class ct_params_t>
-void slvr_common<ct_params_t>::th_LS()
+void slvr_common<ct_params_t>::th_LS(setup::arr_1D_t &lvl_src)
 {
   params.update_th_LS(
     *params.th_LS, this->timestep, params.dt, params.dz
   );
 
-  F(this->ijk).reindex(this->zero) = (*params.th_LS)(this->vert_idx);
+  lvl_src += *params.th_LS;
 }
@@ -2,61 +2,81 @@
 
 //TODO: make these functions return arrays
 
+// per-thread column buffers and tables of the free-atmosphere term, which depends only on the distance from the inversion
+template <class ct_params_t>
+void slvr_common<ct_params_t>::init_radiation()
+{
+  const int nz = this->vert_rng.length();
+  rad_tau_up.resize(nz);
+  rad_tau_dn.resize(nz);
+  rad_fa_43.resize(nz + 1);
+  rad_fa_13.resize(nz + 1);
+  blitz::firstIndex n;
+  rad_fa_43 = pow(n * params.dz, real_t(4./3));
+  rad_fa_13 = pow(n * params.dz, real_t(1./3));
+}
+
+// calc upward radiative flux through the bottom of the cells, Eqs. 5 and 6 from Ackerman et al 2009
+// done column by column: vertical is the contiguous dimension, so all sums over a column,
+// exponentials and the free-atmosphere term are computed while the column is in cache
 template <class ct_params_t>
 void slvr_common<ct_params_t>::radiation(typename parent_t::arr_t &rv)
-// calc upward radiative flux through the bottom of the cells
 {
-  const auto &ijk = this->ijk;
-  if(params.radiation)
+  if(!params.radiation)
   {
-    namespace idxperm = libmpdataxx::idxperm;
-    using ix = typename ct_params_t::ix;
-    constexpr int perm_no=ix::w; // 1 for 2D, 2 for 3D
-  
-    int nz = this->mem->grid_size[perm_no].length(); 
-  
-    // index of first cell above inversion
-    tmp1(ijk)  = rv(ijk) + r_l(ijk);
-  
-    k_i.reindex(this->zero_plane) = blitz::first( tmp1(ijk).reindex(this->zero) < params.ForceParameters.q_i, this->vert_idx); // vertical index of first cell above inversion (inversion is at the lower edge of this cell)
-  
-    // calc Eqs. 5 and 6 from Ackerman et al 2009
-    // calc sum of r_l above certain level and store it in tmp1
-    tmp1(ijk) = r_l(ijk);
-  
-    tmp1(ijk).reindex(this->zero) *= -params.dz * params.ForceParameters.heating_kappa * (*params.rhod)(this->vert_idx);
-  
-    for(int z = nz-2 ; z >= 0; --z)
-      tmp1(idxperm::pi<perm_no>(z, this->hrzntl_subdomain)) += tmp1(idxperm::pi<perm_no>(z+1, this->hrzntl_subdomain));
-  
-    auto ground = idxperm::pi<perm_no>(0, this->hrzntl_subdomain);
-    auto noground = idxperm::pi<perm_no>(rng_t(1, nz-1), this->hrzntl_subdomain);
-    auto notop = idxperm::pi<perm_no>(rng_t(0, nz-2), this->hrzntl_subdomain);
-  
-    radiative_flux(ijk) = params.ForceParameters.F_0 * exp(tmp1(ijk)); 
-  
-    // calc sum of r_l below certain level and store it in tmp1
-    tmp1(ijk) = r_l(ijk);
-  
-    tmp1(ijk).reindex(this->zero) *= - params.dz * params.ForceParameters.heating_kappa * (*params.rhod)(this->vert_idx);
-  
-    // copy one cell upwards
-    for(int z = nz-1 ; z >= 1; --z)
-      tmp1(idxperm::pi<perm_no>(z, this->hrzntl_subdomain)) = tmp1(idxperm::pi<perm_no>(z-1, this->hrzntl_subdomain));
-    tmp1(ground) = 0.;
-  
-    for(int z = 1 ; z <= nz-1; ++z)
-      tmp1(idxperm::pi<perm_no>(z, this->hrzntl_subdomain)) += tmp1(idxperm::pi<perm_no>(z-1, this->hrzntl_subdomain));
-
-    radiative_flux(ijk) += params.ForceParameters.F_1 * exp(tmp1(ijk));
-  
-    // free atmosphere part
-    radiative_flux(ijk).reindex(this->zero) += where(this->vert_idx > k_i.reindex(this->zero_plane)(blitz::tensor::i, blitz::tensor::j),  // works even in 2D ?!?!
-        (libcloudphxx::common::moist_air::c_pd<setup::real_t>() / si::joules * si::kilograms * si::kelvins) * params.ForceParameters.rho_i * params.ForceParameters.D *
-        (0.25 * pow((this->vert_idx - 0.5) * params.dz - (k_i.reindex(this->zero_plane)(blitz::tensor::i, blitz::tensor::j) - .5) * params.dz, 4./3) +
-        (k_i.reindex(this->zero_plane)(blitz::tensor::i, blitz::tensor::j) - .5) * params.dz * pow((this->vert_idx - 0.5) * params.dz - (k_i.reindex(this->zero_plane)(blitz::tensor::i, blitz::tensor::j) - .5) * params.dz, 1./3))
-      , 0);
+    radiative_flux(this->ijk) = 0.;
+    return;
+  }
+
+  constexpr int n_dims = parent_t::n_dims;
+  const int nz = this->vert_rng.length();
+  const auto &fp = params.ForceParameters;
+  const auto &rhod = *params.rhod;
+  const real_t kappa_dz = - params.dz * fp.heating_kappa,
+               fa_coeff = (libcloudphxx::common::moist_air::c_pd<setup::real_t>() / si::joules * si::kilograms * si::kelvins) * fp.rho_i * fp.D;
+  real_t *tau_up = rad_tau_up.data(),
+         *tau_dn = rad_tau_dn.data();
+  const auto s_rv  = rv.stride(n_dims - 1),
+             s_rl  = r_l.stride(n_dims - 1),
+             s_flx = radiative_flux.stride(n_dims - 1);
+
+  // loop over columns of the subdomain
+  for(int c = 0; c < this->n_columns(); ++c)
+  {
+    const auto col = this->column(c);
+    const real_t *rv_c = &rv(col),
+                 *rl_c = &r_l(col);
+    real_t *flx_c = &radiative_flux(col);
+
+    // index of first cell above inversion (inversion is at the lower edge of this cell), nz if there is none
+    int ki = nz;
+    for(int k = 0; k < nz; ++k)
+      if(rv_c[k * s_rv] + rl_c[k * s_rl] < fp.q_i) { ki = k; break; }
+    k_i(this->column_hrzntl(c)) = ki;
+
+    // optical depth of each cell
+    for(int k = 0; k < nz; ++k)
+      tau_up[k] = kappa_dz * rhod(k) * rl_c[k * s_rl];
+
+    // sums below (excluding) and above (including) each level
+    real_t below = 0, above = 0;
+    for(int k = 0; k < nz; ++k)
+    {
+      tau_dn[k] = below;
+      below += tau_up[k];
+    }
+    for(int k = nz - 1; k >= 0; --k)
+    {
+      above += tau_up[k];
+      tau_up[k] = above;
+    }
+
+    #pragma omp simd
+    for(int k = 0; k < nz; ++k)
+      flx_c[k * s_flx] = fp.F_0 * std::exp(tau_up[k]) + fp.F_1 * std::exp(tau_dn[k]);
+
+    // free atmosphere part, only above the inversion
+    for(int k = ki + 1; k < nz; ++k)
+      flx_c[k * s_flx] += fa_coeff * (0.25 * rad_fa_43(k - ki) + (ki - .5) * params.dz * rad_fa_13(k - ki));
   }
-  else
-    radiative_flux(ijk)=0.;
 }
@@ -1,16 +1,13 @@
 #pragma once
 
+// per-level nudging of the horizontal mean, added to the per-level sum of sources
 template <class ct_params_t>
-void slvr_common<ct_params_t>::relax_th_rv(const int &type)
+void slvr_common<ct_params_t>::relax_th_rv(const int &type, setup::arr_1D_t &lvl_src)
 {
-  const auto &ijk = this->ijk;
-  if(params.user_params.relax_th_rv)
-  {
-    if(type == ix::th)
-      F(ijk).reindex(this->zero) = (*params.relax_th_rv_coeff)(this->vert_idx) * ((*params.th_e)(this->vert_idx) - th_mean_prof(this->vert_idx));// / this->n_cell_per_level;
-    else if(type == ix::rv)
-      F(ijk).reindex(this->zero) = (*params.relax_th_rv_coeff)(this->vert_idx) * ((*params.rv_e)(this->vert_idx) - rv_mean_prof(this->vert_idx));// / this->n_cell_per_level;
-  }
-  else
-    F(ijk)=0.;
+  if(!params.user_params.relax_th_rv) return;
+
+  if(type == ix::th)
+    lvl_src += (*params.relax_th_rv_coeff) * ((*params.th_e) - th_mean_prof);// / this->n_cell_per_level;
+  else if(type == ix::rv)
+    lvl_src += (*params.relax_th_rv_coeff) * ((*params.rv_e) - rv_mean_prof);// / this->n_cell_per_level;
 }
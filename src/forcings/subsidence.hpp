@@ -4,6 +4,21 @@
 
 //TODO: make these functions return arrays
 
+// subsidence of the horizontal mean, added to the per-level sum of sources
+template <class ct_params_t>
+void slvr_common<ct_params_t>::subsidence_mean(const int &type, setup::arr_1D_t &lvl_src)
+{
+  const int nz = this->vert_rng.length();
+  // means of registered fields are already computed (in one batch) at the start of update_rhs
+  const int m = mean_prof_idx(type);
+  if(m >= 0)
+    subs_mean(blitz::Range(0, nz-1)) = mean_profs(m, blitz::Range::all());
+  else
+    this->hrzntl_means({{this->state(type), subs_mean}});
+  grad_fwd(subs_mean, subs_grad, params.dz, this->vert_rng); 
+  lvl_src -= subs_grad * (*params.w_LS);
+}
+
 template <class ct_params_t>
 void slvr_common<ct_params_t>::subsidence(const int &type) // large-scale vertical wind
 {
@@ -17,13 +32,39 @@ void slvr_common<ct_params_t>::subsidence(const int &type) // large-scale vertic
   }
   else if(params.subsidence == subs_t::mean)
   {
-    setup::arr_1D_t mean(this->vert_rng.length()+1),
-                    grad(this->vert_rng.length());
-    this->hrzntl_mean(this->state(type), mean);
-    grad_fwd(mean, grad, params.dz, this->vert_rng); 
-    F(ijk).reindex(this->zero) = - grad(this->vert_idx) * (*params.w_LS)(this->vert_idx);
+    subs_prof = 0;
+    subsidence_mean(type, subs_prof);
+    F(ijk).reindex(this->zero) = subs_prof(this->vert_idx);
     //this->smooth(tmp1, F);
   }
   else
     F(ijk)=0.;
 }
+
+// local subsidence of several scalars applied directly, a -= w_LS * da/dz * dt, with the gradient as in vert_grad_cnt;
+// column by column, so no halos and no barriers are needed
+template <class ct_params_t>
+void slvr_common<ct_params_t>::subsidence_apply(std::initializer_list<typename parent_t::arr_t> arrs, const real_t &dt)
+{
+  constexpr int n_dims = ct_params_t::n_dims;
+  const int nz = this->vert_rng.length();
+  const auto &w_LS = *params.w_LS;
+
+  for(auto arr : arrs) // shallow copy
+  {
+    const auto s = arr.stride(n_dims - 1);
+    for(int c = 0; c < this->n_columns(); ++c)
+    {
+      real_t *a_c = &arr(this->column(c));
+
+      // bottom cell is two times lower, no subsidence at the top level
+      subs_grad(0) = (a_c[s] - a_c[0]) / 2. / params.dz * 2;
+      for(int k = 1; k < nz - 1; ++k)
+        subs_grad(k) = (a_c[(k + 1) * s] - a_c[(k - 1) * s]) / 2. / params.dz;
+      subs_grad(nz - 1) = 0;
+
+      for(int k = 0; k < nz; ++k)
+        a_c[k * s] += subs_grad(k) * -w_LS(k) * dt;
+    }
+  }
+}
@@ -3,24 +3,11 @@
 
 //TODO: make these functions return arrays
 
+// update of the surface fluxes of th and rv;
+// in ILES the resulting tendency (flux folded with height) is added in the fused sum of sources (see sum_src),
+// in SMG the fluxes are used as boundary conditions of the SGS fluxes
 template <class ct_params_t>
-void slvr_common<ct_params_t>::surf_sens_impl(iles_tag)
-{
-  params.update_surf_flux_sens(
-    surf_flux_sens(this->hrzntl_slice(0)).reindex(this->origin),
-    this->state(ix::th)(this->hrzntl_slice(0)).reindex(this->origin),
-    U_ground(this->hrzntl_slice(0)).reindex(this->origin),
-    params.dz / 2, this->timestep, this->dt, this->di, this->dj
-  ); // [ K kg / (m^2 s)]
-
-  for (auto k = this->vert_rng.first(); k <= this->vert_rng.last(); ++k)
-  {
-    F(this->hrzntl_slice(k)) = surf_flux_sens(this->hrzntl_slice(0)) * (*params.hgt_fctr)(k) /  (*params.rhod)(k) / calc_exner()((*params.p_e)(k)); // [K/s]
-  }
-}
-
-template <class ct_params_t>
-void slvr_common<ct_params_t>::surf_sens_impl(smg_tag)
+void slvr_common<ct_params_t>::surf_sens()
 {
   params.update_surf_flux_sens(
     surf_flux_sens(this->hrzntl_slice(0)).reindex(this->origin),
@@ -28,36 +15,10 @@ void slvr_common<ct_params_t>::surf_sens_impl(smg_tag)
     U_ground(this->hrzntl_slice(0)).reindex(this->origin),
     params.dz / 2, this->timestep, this->dt, this->di, this->dj
   ); // [K kg / (m^2 s)]
-
-  F(this->ijk) = 0;
-}
-
-template <class ct_params_t>
-void slvr_common<ct_params_t>::surf_sens()
-{
-  surf_sens_impl(sgs_tag{});
-}
-
-template <class ct_params_t>
-void slvr_common<ct_params_t>::surf_latent_impl(iles_tag)
-{
-  this->tmp1(this->hrzntl_slice(0)) = this->state(ix::rv)(this->hrzntl_slice(0)) + this->r_l(this->hrzntl_slice(0));
-
-  params.update_surf_flux_lat(
-    surf_flux_lat(this->hrzntl_slice(0)).reindex(this->origin),
-    this->tmp1(this->hrzntl_slice(0)).reindex(this->origin),
-    U_ground(this->hrzntl_slice(0)).reindex(this->origin),
-    params.dz / 2, this->timestep, this->dt, this->di, this->dj
-  );  // [lg / (m^2 s)]
-
-  for (auto k = this->vert_rng.first(); k <= this->vert_rng.last(); ++k)
-  {
-    F(this->hrzntl_slice(k)) = surf_flux_lat(this->hrzntl_slice(0)) * (*params.hgt_fctr)(k)  /  (*params.rhod)(k); // [1/s]
-  }
 }
 
 template <class ct_params_t>
-void slvr_common<ct_params_t>::surf_latent_impl(smg_tag)
+void slvr_common<ct_params_t>::surf_latent()
 {
   this->tmp1(this->hrzntl_slice(0)) = this->state(ix::rv)(this->hrzntl_slice(0)) + this->r_l(this->hrzntl_slice(0));
 
@@ -67,14 +28,6 @@ void slvr_common<ct_params_t>::surf_latent_impl(smg_tag)
     U_ground(this->hrzntl_slice(0)).reindex(this->origin),
     params.dz / 2, this->timestep, this->dt, this->di, this->dj
   );  // [kg / (m^2 s)]
-
-  F(this->ijk) = 0;
-}
-
-template <class ct_params_t>
-void slvr_common<ct_params_t>::surf_latent()
-{
-  surf_latent_impl(sgs_tag{});
 }
 
 
@@ -88,10 +41,7 @@ void slvr_common<ct_params_t>::surf_u_impl(iles_tag)
     params.dz / 2, this->timestep, this->dt, this->di, this->dj, params.ForceParameters.uv_mean[0]
   );
 
-  for (auto k = this->vert_rng.first(); k <= this->vert_rng.last(); ++k)
-  {
-    F(this->hrzntl_slice(k)) = surf_flux_u(this->hrzntl_slice(0)) * (*params.hgt_fctr)(k) /  (*params.rhod)(k); // [m/s^2]
-  }
+  F(this->ijk) = this->srfc_view(surf_flux_u) * this->vert_prof_view(hgt_rhod_fctr); // [m/s^2]
 }
 
 template <class ct_params_t>
@@ -118,10 +68,7 @@ void slvr_common<ct_params_t>::surf_v_impl(iles_tag)
     params.dz / 2, this->timestep, this->dt, this->di, this->dj, params.ForceParameters.uv_mean[1]
   );
 
-  for (auto k = this->vert_rng.first(); k <= this->vert_rng.last(); ++k)
-  {
-    F(this->hrzntl_slice(k)) = surf_flux_v(this->hrzntl_slice(0)) * (*params.hgt_fctr)(k) /  (*params.rhod)(k); // [m/s^2]
-  }
+  F(this->ijk) = this->srfc_view(surf_flux_v) * this->vert_prof_view(hgt_rhod_fctr); // [m/s^2]
 }
 
 template <class ct_params_t>
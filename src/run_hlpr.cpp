@@ -21,10 +21,8 @@
 
 #include "opts/opts_common.hpp"
 #include "solvers/common/calc_forces_common.hpp"
-
-#if defined(UWLCM_TIMING)
-  #include "detail/exec_timer.hpp"
-#endif
+#include "detail/exec_timer.hpp"
+#include "detail/estimate.hpp"
 
 #if !defined(UWLCM_DISABLE_2D_LGRNGN) || !defined(UWLCM_DISABLE_3D_LGRNGN)
   #include "opts/opts_lgrngn.hpp"
@@ -105,7 +103,7 @@ void run(const int (&nps)[n_dims], const user_params_t &user_params)
   else if (user_params.model_case == "cumulus_congestus_icmw20")
     case_ptr.reset(new cases::CumulusCongestus::CumulusCongestus_icmw20<case_ct_params_t, n_dims>(user_params.X, user_params.Y, user_params.Z, user_params.window));
   else if (user_params.model_case == "cumulus_congestus_icmw24")
-    case_ptr.reset(new cases::CumulusCongestus::CumulusCongestus_icmw24<case_ct_params_t, n_dims>(user_params.X, user_params.Y, user_params.Z, user_params.window));
+    case_ptr.reset(new cases::CumulusCongestus::CumulusCongestus_icmw24<case_ct_params_t, n_dims>(user_params.X, user_params.Y, user_params.Z, user_params.window, user_params.sounding_file));
   else if (user_params.model_case == "rico11")
     case_ptr.reset(new cases::rico::Rico11<case_ct_params_t, n_dims>(user_params.X, user_params.Y, user_params.Z, user_params.window));
   else if (user_params.model_case == "dry_pbl")
@@ -115,6 +113,9 @@ void run(const int (&nps)[n_dims], const user_params_t &user_params)
   else
     throw std::runtime_error("UWLCM: wrong case choice");
 
+  if(user_params.sounding_file != "" && user_params.model_case != "cumulus_congestus_icmw24")
+    throw std::runtime_error("UWLCM: initial sounding from a file can only be used in the cumulus_congestus_icmw24 case");
+
   // instantiation of structure containing simulation parameters
   rt_params_t p;
 
@@ -153,6 +154,15 @@ void run(const int (&nps)[n_dims], const user_params_t &user_params)
   // pass them to rt_params
   detail::copy_profiles(profs, p);
 
+  // buffers for horizontal means, shared among threads
+  detail::hrzntl_sums_t hrzntl_sums;
+  p.hrzntl_sums = &hrzntl_sums;
+
+  // timings of code regions, shared among threads (each thread writes only to its own part)
+  detail::profiler_t prof(user_params.prof, user_params.prof_counters,
+    user_params.trace_from, user_params.trace_to < 0 ? user_params.trace_from : user_params.trace_to);
+  p.prof = &prof;
+
   // set case-specific options, needs to be done after copy_profiles
   case_ptr->setopts(p, nps, user_params);
   // set micro-specific options, needs to be done after copy_profiles
@@ -169,6 +179,25 @@ void run(const int (&nps)[n_dims], const user_params_t &user_params)
     p.outvars.insert({1, {"v", "[m/s]"}});
   }
 
+  // pre-flight estimate of memory and output, the simulation is not run
+  std::unique_ptr<detail::estimate_t> est;
+  if(user_params.estimate)
+  {
+    est.reset(new detail::estimate_t(std::vector<int>(nps, nps + n_dims), user_params.estimate_procs, solver_t::halo, sizeof(typename solver_t::real_t)));
+    solver_t::estimate(*est, p);
+    est->print(std::cout, user_params.nt, user_params.outfreq, user_params.outstart, user_params.outwindow);
+    if(user_params.estimate_steps == 0) return;
+
+    // calibration: a few timesteps of the same setup, only the initial state is written (to outdir/estimate)
+    p.outdir = p.user_params.outdir = user_params.outdir + "/estimate";
+    p.user_params.nt = user_params.estimate_steps;
+    p.outfreq = p.user_params.outfreq = user_params.estimate_steps + 1;
+  }
+
+  // progress of the run, rewritten in the loop
+  detail::status_t status(p.outdir + "/status.json", user_params.status_interval);
+  if(user_params.status_interval > 0) p.status = &status;
+
   // solver instantiation
   std::unique_ptr<concurr_any_t> concurr;
 
@@ -186,23 +215,49 @@ void run(const int (&nps)[n_dims], const user_params_t &user_params)
     concurr.reset(new concurr_openmp_cyclic_gndsky_t(p));
   }
   
+  // arrays are allocated in the concurr constructor
+  detail::mem_ledger().mark("setup");
+
+#if defined(UWLCM_TIMING)
+  auto tbeg_intcond = setup::clock::now();
+#endif
+
   case_ptr->intcond(*concurr.get(), profs.rhod, profs.th_e, profs.rv_e, profs.rl_e, profs.p_e, user_params.rng_seed_init, nps);
 
+#if defined(UWLCM_TIMING)
+  // initial condition setup is not part of the timestepping loop timed in exec_timer
+  std::cout << "intcond wall time in milliseconds: " 
+    << std::chrono::duration_cast<setup::timer>(setup::clock::now() - tbeg_intcond).count() << std::endl;
+#endif
+
   // setup panic pointer and the signal handler
   panic = concurr->panic_ptr();
   set_sigaction();
  
   // timestepping
-  concurr->advance(user_params.nt);
+  concurr->advance(p.user_params.nt);
+  if(*panic) status.stopped();
+  else status.finished();
+
+  if(est)
+  {
+    detail::mem_ledger().mark("end");
+    est->print_calibration(std::cout, detail::mem_ledger(), user_params.estimate_steps, user_params.nt);
+    return;
+  }
+
+  // also if stopped with the panic flag
+  if(user_params.prof)
+    prof.write(user_params.outdir + "/profile.json", user_params.nt, !*panic);
+  if(prof.tracing())
+    prof.write_trace(user_params.outdir + "/trace.json");
+
+  detail::mem_ledger().mark("end");
+  detail::mem_ledger().write(user_params.outdir + "/memory.json");
 }
 
-#if defined(UWLCM_TIMING)
-  template<class slvr>
-  using timer = exec_timer<slvr>;
-#else
-  template<class slvr>
-  using timer = slvr;
-#endif
+template<class slvr>
+using timer = exec_timer<slvr>;
 
 
 template<template<class...> class slvr, class ct_params_dim_micro, int n_dims>
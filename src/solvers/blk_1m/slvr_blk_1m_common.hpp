@@ -33,31 +33,32 @@ class slvr_blk_1m_common : public std::conditional_t<ct_params_t::sgs_scheme ==
   typename parent_t::arr_t &precipitation_rate; 
 
   private:
-  // a 2D/3D array with copy of the environmental total pressure of dry air 
-  typename parent_t::arr_t &p_e;
-
 
   /**
    * @brief Perform condensation/evaporation adjustment for the current cell
    *
    * Updates cloud water and rain water mixing ratios using the libcloudph++ blk_1m
-   * library routines.
+   * library routines. Called column by column, so that the environmental pressure
+   * is passed as its vertical profile (a zero-stride view of it is not walked correctly by blitz iterators).
    */
   void condevap()
   {
-    auto
-      th   = this->state(ix::th)(this->ijk), // potential temperature
-      rv   = this->state(ix::rv)(this->ijk), // water vapour mixing ratio
-      rc   = this->state(ix::rc)(this->ijk), // cloud water mixing ratio
-      rr   = this->state(ix::rr)(this->ijk); // rain water mixing ratio
-    auto const
-      rhod = (*this->mem->G)(this->ijk),
-      &p_e_arg = p_e(this->ijk);
-
-    libcloudphxx::blk_1m::adj_cellwise<real_t>( 
-      params.cloudph_opts, rhod, p_e_arg, th, rv, rc, rr, this->dt
-    );
-    this->mem->barrier();
+    const auto p_e_arg = (*params.p_e)(this->vert_rng);
+    for(int c = 0; c < this->n_columns(); ++c)
+    {
+      auto
+        th   = this->column_view(this->state(ix::th), c), // potential temperature
+        rv   = this->column_view(this->state(ix::rv), c), // water vapour mixing ratio
+        rc   = this->column_view(this->state(ix::rc), c), // cloud water mixing ratio
+        rr   = this->column_view(this->state(ix::rr), c); // rain water mixing ratio
+      auto const
+        rhod = this->column_view(*this->mem->G, c);
+
+      libcloudphxx::blk_1m::adj_cellwise<real_t>( 
+        params.cloudph_opts, rhod, p_e_arg, th, rv, rc, rr, this->dt
+      );
+    }
+    this->barrier_at("condevap");
   }
 
   protected:
@@ -107,9 +108,6 @@ class slvr_blk_1m_common : public std::conditional_t<ct_params_t::sgs_scheme ==
     this->state(ix::rc)(this->ijk) = 0;
     this->state(ix::rr)(this->ijk) = 0;
 
-    // init the p_e array
-    p_e(this->ijk).reindex(this->zero) = (*params.p_e)(this->vert_idx);
-
     // deal with initial supersaturation, TODO: don't do it here (vide slvr_lgrngn)
     condevap();
 
@@ -143,14 +141,17 @@ class slvr_blk_1m_common : public std::conditional_t<ct_params_t::sgs_scheme ==
     negtozero(this->mem->advectee(ix::rc)(this->ijk), "rc after first half of rhs");
     negtozero(this->mem->advectee(ix::rr)(this->ijk), "rr after first half of rhs");
 
-    condevap(); 
+    {
+      detail::prof_scope_t prof_scope(params.prof, this->rank, detail::prof_micro);
+      condevap();
+    }
     nancheck(this->mem->advectee(ix::rv)(this->ijk), "rv after condevap");
     nancheck(this->mem->advectee(ix::rc)(this->ijk), "rc after condevap");
     nancheck(this->mem->advectee(ix::rr)(this->ijk), "rr after condevap");
     negcheck(this->mem->advectee(ix::rv)(this->ijk), "rv after condevap");
     negcheck(this->mem->advectee(ix::rc)(this->ijk), "rc after condevap");
     negcheck(this->mem->advectee(ix::rr)(this->ijk), "rr after condevap");
-    this->mem->barrier();
+    this->barrier_at("hook_ante_step: after condevap");
   }
 
   void hook_post_step()
@@ -174,10 +175,21 @@ class slvr_blk_1m_common : public std::conditional_t<ct_params_t::sgs_scheme ==
 
   public:
 
+  // number of arrays allocated in alloc(), also counted by estimate()
+  static constexpr int n_tmp = 1; // precipitation_rate
+
   static void alloc(typename parent_t::mem_t *mem, const int &n_iters)
   {
     parent_t::alloc(mem, n_iters);
-    parent_t::alloc_tmp_sclr(mem, __FILE__, 2); // p_e, precipitation_rate
+    parent_t::alloc_tmp_sclr(mem, __FILE__, n_tmp); // precipitation_rate
+    detail::mem_ledger().add_tmp(mem, __FILE__, "precipitation_rate");
+  }
+
+  static void estimate(detail::estimate_t &est, const rt_params_t &p)
+  {
+    parent_t::estimate(est, p);
+    est.arrays(__FILE__, "precipitation_rate", n_tmp);
+    est.fields(1); // precip_rate
   }
 
   void update_rhs(
@@ -194,7 +206,13 @@ class slvr_blk_1m_common : public std::conditional_t<ct_params_t::sgs_scheme ==
     parent_t(args, p),
     params(p),
     liquid_puddle(0),
-    p_e(args.mem->tmp[__FILE__][0][0]),
-    precipitation_rate(args.mem->tmp[__FILE__][0][1])
-  {}  
+    precipitation_rate(args.mem->tmp[__FILE__][0][0])
+  {
+    // means for subsidence computed together with the other fields
+    if(p.subsidence == subs_t::mean)
+    {
+      if(p.rc_src) this->add_mean_prof(ix::rc);
+      if(p.rr_src) this->add_mean_prof(ix::rr);
+    }
+  }  
 };
@@ -35,30 +35,36 @@ void slvr_blk_1m_common<ct_params_t>::update_rhs(
   if(at ==0)
     precipitation_rate(this->ijk) = 0;
 
-  this->mem->barrier();
+  this->barrier_at("update_rhs blk_1m: precipitation rate zeroed");
 
   // cell-wise
   // TODO: rozne cell-wise na n i n+1 ?
   if(at == 0)
   {
-    auto
-      dot_th = rhs.at(ix::th)(this->ijk),
-      dot_rv = rhs.at(ix::rv)(this->ijk),
-      dot_rc = rhs.at(ix::rc)(this->ijk),
-      dot_rr = rhs.at(ix::rr)(this->ijk);
-    const auto
-      th   = this->state(ix::th)(this->ijk),
-      rv   = this->state(ix::rv)(this->ijk),
-      rc   = this->state(ix::rc)(this->ijk),
-      rr   = this->state(ix::rr)(this->ijk),
-      rhod = (*this->mem->G)(this->ijk),
-      &p_e_arg = p_e(this->ijk);
-    libcloudphxx::blk_1m::rhs_cellwise_revap<real_t>(
-        params.cloudph_opts,
-        dot_th, dot_rv, dot_rc, dot_rr,
-        rhod, p_e_arg, th, rv, rc, rr,
-        dt
-    );
+    detail::prof_scope_t prof_scope(params.prof, this->rank, detail::prof_micro);
+
+    // column by column, with the environmental pressure as its vertical profile (see condevap)
+    const auto p_e_arg = (*params.p_e)(this->vert_rng);
+    for(int c = 0; c < this->n_columns(); ++c)
+    {
+      auto
+        dot_th = this->column_view(rhs.at(ix::th), c),
+        dot_rv = this->column_view(rhs.at(ix::rv), c),
+        dot_rc = this->column_view(rhs.at(ix::rc), c),
+        dot_rr = this->column_view(rhs.at(ix::rr), c);
+      const auto
+        th   = this->column_view(this->state(ix::th), c),
+        rv   = this->column_view(this->state(ix::rv), c),
+        rc   = this->column_view(this->state(ix::rc), c),
+        rr   = this->column_view(this->state(ix::rr), c),
+        rhod = this->column_view(*this->mem->G, c);
+      libcloudphxx::blk_1m::rhs_cellwise_revap<real_t>(
+          params.cloudph_opts,
+          dot_th, dot_rv, dot_rc, dot_rr,
+          rhod, p_e_arg, th, rv, rc, rr,
+          dt
+      );
+    }
 
     nancheck(rhs.at(ix::th)(this->ijk), "RHS of th after rhs_cellwise");
     nancheck(rhs.at(ix::rv)(this->ijk), "RHS of rv after rhs_cellwise");
@@ -112,5 +118,5 @@ void slvr_blk_1m_common<ct_params_t>::update_rhs(
       break;
     }
   }
-  this->mem->barrier();
+  this->barrier_at("update_rhs blk_1m: cellwise and forcings");
 }
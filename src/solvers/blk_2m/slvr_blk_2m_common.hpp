@@ -30,12 +30,6 @@ class slvr_blk_2m_common : public std::conditional_t<ct_params_t::sgs_scheme ==
   typename parent_t::arr_t &rr_flux;
   typename parent_t::arr_t &nr_flux;
 
-  private:
-  // a 2D/3D array with copy of the environmental total pressure of dry air
-  typename parent_t::arr_t &p_e;
-
-  protected:
-
   // accumulated water falling out of domain
   real_t liquid_puddle;
 
@@ -124,9 +118,6 @@ class slvr_blk_2m_common : public std::conditional_t<ct_params_t::sgs_scheme ==
     this->state(ix::nc)(this->ijk) = 0;
     this->state(ix::nr)(this->ijk) = 0;
 
-    // init the p_e array
-    p_e(this->ijk).reindex(this->zero) = (*params.p_e)(this->vert_idx);
-
     parent_t::hook_ante_loop(nt); // forcings after adjustments
 
     // recording parameters
@@ -158,7 +149,7 @@ class slvr_blk_2m_common : public std::conditional_t<ct_params_t::sgs_scheme ==
     negtozero(this->mem->advectee(ix::rr)(this->ijk), "rr after first half of rhs");
     negtozero(this->mem->advectee(ix::nc)(this->ijk), "nc after first half of rhs");
     negtozero(this->mem->advectee(ix::nr)(this->ijk), "nr after first half of rhs");
-    this->mem->barrier();
+    this->barrier_at("hook_ante_step: after negtozero");
   }
 
 
@@ -183,10 +174,21 @@ class slvr_blk_2m_common : public std::conditional_t<ct_params_t::sgs_scheme ==
 
   public:
 
+  // number of arrays allocated in alloc(), also counted by estimate()
+  static constexpr int n_tmp = 2; // rr_flux, nr_flux
+
   static void alloc(typename parent_t::mem_t *mem, const int &n_iters)
   {
     parent_t::alloc(mem, n_iters);
-    parent_t::alloc_tmp_sclr(mem, __FILE__, 3); // p_e, rr_flux, nr_flux
+    parent_t::alloc_tmp_sclr(mem, __FILE__, n_tmp); // rr_flux, nr_flux
+    detail::mem_ledger().add_tmp(mem, __FILE__, "rr_flux, nr_flux");
+  }
+
+  static void estimate(detail::estimate_t &est, const rt_params_t &p)
+  {
+    parent_t::estimate(est, p);
+    est.arrays(__FILE__, "rr_flux, nr_flux", n_tmp);
+    est.fields(2); // precip_rate_rr, precip_rate_nr
   }
 
   /**
@@ -213,8 +215,16 @@ class slvr_blk_2m_common : public std::conditional_t<ct_params_t::sgs_scheme ==
     parent_t(args, p),
     params(p),
     liquid_puddle(0),
-    p_e(args.mem->tmp[__FILE__][0][0]),
-    rr_flux(args.mem->tmp[__FILE__][0][1]),
-    nr_flux(args.mem->tmp[__FILE__][0][2])
-  {}
+    rr_flux(args.mem->tmp[__FILE__][0][0]),
+    nr_flux(args.mem->tmp[__FILE__][0][1])
+  {
+    // means for subsidence computed together with the other fields
+    if(p.subsidence == subs_t::mean)
+    {
+      if(p.rc_src) this->add_mean_prof(ix::rc);
+      if(p.nc_src) this->add_mean_prof(ix::nc);
+      if(p.rr_src) this->add_mean_prof(ix::rr);
+      if(p.nr_src) this->add_mean_prof(ix::nr);
+    }
+  }
 };
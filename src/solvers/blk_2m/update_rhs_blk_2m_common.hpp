@@ -42,39 +42,49 @@ void slvr_blk_2m_common<ct_params_t>::update_rhs(
     nr_flux(this->ijk) = 0;
   }
 
-  this->mem->barrier();
+  this->barrier_at("update_rhs blk_2m: fluxes zeroed");
 
   // cell-wise
   // TODO: rozne cell-wise na n i n+1 ?
   if(at == 0)
   {
-    auto
-      dot_th = rhs.at(ix::th)(this->ijk),
-      dot_rv = rhs.at(ix::rv)(this->ijk),
-      dot_rc = rhs.at(ix::rc)(this->ijk),
-      dot_nc = rhs.at(ix::nc)(this->ijk),
-      dot_rr = rhs.at(ix::rr)(this->ijk),
-      dot_nr = rhs.at(ix::nr)(this->ijk);
+    detail::prof_scope_t prof_scope(params.prof, this->rank, detail::prof_micro);
+
      const auto
-      th     = this->state(ix::th)(this->ijk),
-      rv     = this->state(ix::rv)(this->ijk),
-      rc     = this->state(ix::rc)(this->ijk),
       nc     = this->state(ix::nc)(this->ijk),
-      rr     = this->state(ix::rr)(this->ijk),
-      nr     = this->state(ix::nr)(this->ijk),
-      rhod   = (*this->mem->G)(this->ijk),
-      &p_e_arg = p_e(this->ijk); //TODO: use const pressure in blk_2m
+      nr     = this->state(ix::nr)(this->ijk);
       nancheck(nc, "nc before blk_2m rhs_cellwise call");
       negtozero(this->state(ix::nc)(this->ijk), "nc before blk_2m rhs_cellwise call");
       negcheck(nc, "nc before blk_2m rhs_cellwise call");
       nancheck(nr, "nr before blk_2m rhs_cellwise call");
       negtozero(this->state(ix::nr)(this->ijk), "nr before blk_2m rhs_cellwise call");
       negcheck(nr, "nr before blk_2m rhs_cellwise call");
-     libcloudphxx::blk_2m::rhs_cellwise<real_t>(
-      params.cloudph_opts, dot_th,  dot_rv, dot_rc, dot_nc, dot_rr, dot_nr,
-      rhod, th,     rv,     rc,     nc,     rr,     nr,
-      this->dt, p_e_arg
-    );
+
+    // column by column, with the environmental pressure as its vertical profile
+    const auto p_e_arg = (*params.p_e)(this->vert_rng);
+    for(int c = 0; c < this->n_columns(); ++c)
+    {
+      auto
+        dot_th = this->column_view(rhs.at(ix::th), c),
+        dot_rv = this->column_view(rhs.at(ix::rv), c),
+        dot_rc = this->column_view(rhs.at(ix::rc), c),
+        dot_nc = this->column_view(rhs.at(ix::nc), c),
+        dot_rr = this->column_view(rhs.at(ix::rr), c),
+        dot_nr = this->column_view(rhs.at(ix::nr), c);
+      const auto
+        th_c   = this->column_view(this->state(ix::th), c),
+        rv_c   = this->column_view(this->state(ix::rv), c),
+        rc_c   = this->column_view(this->state(ix::rc), c),
+        nc_c   = this->column_view(this->state(ix::nc), c),
+        rr_c   = this->column_view(this->state(ix::rr), c),
+        nr_c   = this->column_view(this->state(ix::nr), c),
+        rhod   = this->column_view(*this->mem->G, c);
+      libcloudphxx::blk_2m::rhs_cellwise<real_t>(
+        params.cloudph_opts, dot_th,  dot_rv, dot_rc, dot_nc, dot_rr, dot_nr,
+        rhod, th_c,   rv_c,   rc_c,   nc_c,   rr_c,   nr_c,
+        this->dt, p_e_arg
+      );
+    }
       nancheck(nc, "nc after blk_2m rhs_cellwise call");
       negcheck(nc, "nc after blk_2m rhs_cellwise call");
       nancheck(nc, "nr after blk_2m rhs_cellwise call");
@@ -10,44 +10,70 @@
 #include "../../forcings/surface_fluxes.hpp"
 #include "../../forcings/large_scales.hpp"
 
+/**
+ * @brief Sum all sources of rv or th into `alpha` in a single sweep over the subdomain.
+ *
+ * Forcings that depend only on height (large-scale advection, nudging, subsidence of the mean)
+ * are first summed into the 1D profile `lvl`. The 2D/3D terms are read through views set up
+ * in hook_ante_loop (see set_src_views): radiative heating (already computed in `alpha`),
+ * surface flux folded with height and local subsidence (stored in `F`).
+ * Views of disabled terms point to a zero profile, so that no full-domain array is zero-filled or re-read for them.
+ *
+ * @param rad View of the radiative heating rate (zero if not applied).
+ * @param srfc View of the surface flux (zero if not applied).
+ * @param srfc_fctr Per-level factor converting the surface flux into a tendency.
+ * @param lvl Per-level sum of sources.
+ */
+template <class ct_params_t>
+void slvr_common<ct_params_t>::sum_src(
+  const typename parent_t::arr_t &rad,
+  const typename parent_t::arr_t &srfc,
+  const setup::arr_1D_t &srfc_fctr,
+  const setup::arr_1D_t &lvl
+)
+{
+  alpha(this->ijk) = rad + srfc * this->vert_prof_view(srfc_fctr) + subs_src + this->vert_prof_view(lvl);
+}
+
 /**
  * @brief Apply source term for water vapor (rv) due to surface fluxes, large-scale vertical motion,
  * horizontal advection, and per-level nudging.
  *
- * If `params.rv_src` is true, the function sequentially applies:
+ * If `params.rv_src` is true, the function applies:
  *  - surface latent heat flux,
  *  - subsidence (large-scale vertical wind),
  *  - large-scale horizontal advection,
  *  - nudging of the mean water vapor.
- * The forcing coefficient `alpha` accumulates contributions from all sources, and `beta` is set to zero.
+ * Per-level contributions are summed into a 1D profile and everything is added to
+ * the forcing coefficient `alpha` in one sweep (see sum_src). `beta` is zeroed once in hook_ante_loop.
  */
-// TODO: make functions return blitz arrays to avoid unnecessary copies
 template <class ct_params_t>
 void slvr_common<ct_params_t>::rv_src()
 {
   const auto &ijk = this->ijk;
   if(params.rv_src)
   {
+    lvl_src = 0;
+
     // surface flux
     surf_latent();
-    alpha(ijk) = F(ijk);
 
     // large-scale vertical wind
-    subsidence(ix::rv);
-    alpha(ijk) += F(ijk);
+    if(params.subsidence == subs_t::local)
+      subsidence(ix::rv);
+    else if(params.subsidence == subs_t::mean)
+      subsidence_mean(ix::rv, lvl_src);
 
     // large-scale horizontal advection
-    rv_LS();
-    alpha(ijk) += F(ijk);
+    rv_LS(lvl_src);
 
     // per-level nudging of the mean
-    relax_th_rv(ix::rv);
-    alpha(ijk) += F(ijk);
+    relax_th_rv(ix::rv, lvl_src);
+
+    sum_src(zero_src, srfc_lat_src, srfc_lat_fctr, lvl_src);
   }
   else
     alpha(ijk) = 0.;
-
-  beta(ijk) = 0.;
 }
 
 
@@ -55,7 +81,7 @@ void slvr_common<ct_params_t>::rv_src()
  * @brief Apply source term for potential temperature (th) due to radiation, surface fluxes,
  * large-scale motions, and per-level nudging.
  *
- * If `params.th_src` is true, the function sequentially applies:
+ * If `params.th_src` is true, the function applies:
  *  - radiative heating,
  *  - vertical flux divergence to compute local heating rate,
  *  - surface sensible heat flux,
@@ -63,8 +89,8 @@ void slvr_common<ct_params_t>::rv_src()
  *  - large-scale horizontal advection,
  *  - nudging of the mean potential temperature.
  *
- * The forcing coefficient `alpha` accumulates contributions from all sources, corrected for
- * specific heat and density. The `beta` coefficient is set to zero.
+ * The radiative heating rate is computed in `alpha`, corrected for specific heat and density.
+ * Other contributions are added to it in one sweep (see sum_src). `beta` is zeroed once in hook_ante_loop.
  *
  * @param rv Array of water vapor used for computing heat capacities and radiative effects.
  */
@@ -74,46 +100,47 @@ void slvr_common<ct_params_t>::th_src(typename parent_t::arr_t &rv)
   const auto &ijk = this->ijk;
   if(params.th_src)
   {
+    lvl_src = 0;
+
     // -- heating --
 
     // radiation
-    radiation(rv);
-    nancheck(radiative_flux(ijk), "radiation");
-    
-    // sum of th flux, F(j) is upward flux through the bottom of the j-th cell
-    this->vert_grad_fwd(radiative_flux, alpha, params.dz);
-    alpha(ijk) *= -1; // negative gradient means inflow
-    nancheck(alpha(ijk), "sum of th flux");
-    
-    // change of theta[K/s] = heating[W/m^3] / exner / c_p[J/K/kg] / this->rhod[kg/m^3]
-    alpha(ijk).reindex(this->zero) /=  calc_exner()((*params.p_e)(this->vert_idx)) *
-      calc_c_p()(rv(ijk).reindex(this->zero)) *
-      (*params.rhod)(this->vert_idx);
-    nancheck2(alpha(ijk), this->state(ix::th)(ijk), "change of theta");
+    if(params.radiation)
+    {
+      radiation(rv);
+      nancheck(radiative_flux(ijk), "radiation");
+      
+      // sum of th flux, F(j) is upward flux through the bottom of the j-th cell
+      this->vert_grad_fwd(radiative_flux, alpha, params.dz);
+      
+      // change of theta[K/s] = heating[W/m^3] / exner / c_p[J/K/kg] / this->rhod[kg/m^3], negative gradient means inflow
+      alpha(ijk) *= - this->vert_prof_view(rhod_exner_inv) / calc_c_p()(rv(ijk));
+      nancheck2(alpha(ijk), this->state(ix::th)(ijk), "change of theta");
+    }
 
     // surf flux = d/dz mean(theta*w) [K/s]
     surf_sens();
-    nancheck(F(ijk), "sensible surf forcing");
-    alpha(ijk) += F(ijk);
   
     // large-scale vertical wind
-    subsidence(ix::th);
-    nancheck(F(ijk), "subsidence");
-    alpha(ijk) += F(ijk);
-    nancheck(alpha(ijk), "alpha in th_src");
+    if(params.subsidence == subs_t::local)
+    {
+      subsidence(ix::th);
+      nancheck(F(ijk), "subsidence");
+    }
+    else if(params.subsidence == subs_t::mean)
+      subsidence_mean(ix::th, lvl_src);
 
     // large-scale horizontal advection
-    th_LS();
-    alpha(ijk) += F(ijk);
+    th_LS(lvl_src);
 
     // per-level nudging of the mean
-    relax_th_rv(ix::th);
-    alpha(ijk) += F(ijk);
+    relax_th_rv(ix::th, lvl_src);
+
+    sum_src(rad_src, srfc_sens_src, srfc_sens_fctr, lvl_src);
+    nancheck(alpha(ijk), "alpha in th_src");
   }
   else
     alpha(ijk) = 0.;
-
-  beta(ijk) = 0.;
 }
 
 
@@ -123,6 +150,8 @@ void slvr_common<ct_params_t>::th_src(typename parent_t::arr_t &rv)
  * The function computes buoyancy forcing based on `th` and `rv`, applies trapezoidal scaling
  * (halving `alpha`), and optionally adds large-scale vertical motion if `at == 0` and
  * `params.vel_subsidence` is true.
+ * Buoyancy computed at n+1 (`at == 1`) is kept in `buoy` and reused at n of the next timestep,
+ * if nothing modifies th, rv and r_l in between (see `buoy_reuse`).
  *
  * @param th Array of potential temperature.
  * @param rv Array of water vapor.
@@ -133,13 +162,24 @@ void slvr_common<ct_params_t>::w_src(typename parent_t::arr_t &th, typename pare
 {
   const auto &ijk = this->ijk;
   // buoyancy
-  // TODO: buoyancy is now calculated twice, at n and at n+1, make it so that it is calculated once (will need to remove zeroing-out of w rhs in parent:update-rhs)
-  buoyancy(th, rv);
-  alpha(ijk) = 0.5 * F(ijk); // halved, because it is applied trapezoidaly
-  if(at == 0 && params.vel_subsidence) // subsidence added explicitly, so updated only at n
+  if(!(at == 0 && buoy_valid))
+    buoyancy(th, rv);
+  buoy_valid = at == 1 && buoy_reuse;
+
+  if(at == 0 && params.vel_subsidence && params.subsidence == subs_t::mean) // subsidence added explicitly, so updated only at n
   {
     // large-scale vertical wind
-    subsidence(ix::w);
-    alpha(ijk) += F(ijk);
+    lvl_src = 0;
+    subsidence_mean(ix::w, lvl_src);
+    alpha(ijk) = 0.5 * buoy(ijk) + this->vert_prof_view(lvl_src); // buoyancy halved, because it is applied trapezoidaly
+  }
+  else
+  {
+    alpha(ijk) = 0.5 * buoy(ijk); // halved, because it is applied trapezoidaly
+    if(at == 0 && params.vel_subsidence && params.subsidence == subs_t::local)
+    {
+      subsidence(ix::w);
+      alpha(ijk) += F(ijk);
+    }
   }
 }
@@ -30,6 +30,16 @@ void slvr_lgrngn<ct_params_t>::diag()
   prtcls->diag_sd_conc();
   this->record_aux("sd_conc", prtcls->outbuf());
 
+  // total number of super-droplets for the status file
+  if(params.status != nullptr)
+  {
+    double n_sd = blitz::sum(typename parent_t::arr_t(prtcls->outbuf(), this->r_l(this->domain).shape(), blitz::neverDeleteData));
+#if defined(USE_MPI)
+    n_sd = boost::mpi::all_reduce(boost::mpi::communicator(), n_sd, std::plus<double>());
+#endif
+    params.status->super_droplets(n_sd);
+  }
+
   // recording concentration of SDs that represent activated droplets 
   /*
   prtcls->diag_rw_ge_rc();
@@ -17,6 +17,7 @@ void slvr_lgrngn<ct_params_t>::hook_ante_delayed_step()
       params.async
     ) {
       assert(ftr.valid());
+      detail::prof_scope_t prof_scope(params.prof, this->rank, detail::prof_async_wait);
 #if defined(UWLCM_TIMING)
       tbeg = setup::clock::now();
 #endif
@@ -32,14 +33,13 @@ void slvr_lgrngn<ct_params_t>::hook_ante_delayed_step()
     } else assert(!ftr.valid()); 
 #endif
   }
-  this->mem->barrier();
+  this->barrier_at("hook_ante_delayed_step: step_cond finished");
 
   // add microphysics contribution to th and rv
   if(params.cloudph_opts.cond)
   {
     // with cyclic bcond, th and rv in corresponding edge cells needs to change by the same amount
-    this->avg_edge_sclr(rv_post_cond, this->ijk);
-    this->avg_edge_sclr(th_post_cond, this->ijk);
+    this->avg_edge_sclrs({rv_post_cond, th_post_cond});
 
     this->state(ix::rv)(this->ijk) += rv_post_cond(this->ijk) - rv_pre_cond(this->ijk); 
     this->state(ix::th)(this->ijk) += th_post_cond(this->ijk) - th_pre_cond(this->ijk); 
@@ -52,9 +52,7 @@ void slvr_lgrngn<ct_params_t>::hook_ante_delayed_step()
   }
 
   // store liquid water content (post-cond, pre-adve and pre-subsidence)
-  diag_rl();
-  if(ct_params_t::sgs_scheme == libmpdataxx::solvers::smg)
-    diag_rc();
+  diag_rl_rc();
     
   if (this->rank == 0) 
   {
@@ -66,6 +64,7 @@ void slvr_lgrngn<ct_params_t>::hook_ante_delayed_step()
 #if defined(UWLCM_TIMING)
       tbeg = setup::clock::now();
 #endif
+      detail::prof_scope_t prof_scope(params.prof, this->rank, detail::prof_micro);
 #if defined(STD_FUTURE_WORKS)
       if (params.async)
       {
@@ -93,34 +92,11 @@ void slvr_lgrngn<ct_params_t>::hook_ante_delayed_step()
 #endif
     }
   }
-  this->mem->barrier();
+  this->barrier_at("hook_ante_delayed_step: step_async");
 
-  // subsidence of rl
-  // TODO: very similar code to subsidence function in forcings.hppp
+  // subsidence of rl and rc
   if(params.subsidence == subs_t::local || params.subsidence == subs_t::mean) // done locally either way
-  {
-    auto& tmp1(this->tmp1);
-    auto& r_l(this->r_l);
-    const auto& ijk(this->ijk);
-    const auto& params(this->params);
-    auto& F(this->F);
-
-    tmp1(ijk) = r_l(ijk);
-    // fill halos for gradient calculation
-    // TODO: no need to xchng in horizontal, which potentially causes MPI communication
-    this->xchng_sclr(tmp1, this->ijk, this->halo);
-    this->vert_grad_cnt(tmp1, F, params.dz);
-    F(ijk).reindex(this->zero) *= - (*params.w_LS)(this->vert_idx);
-    r_l(ijk) += F(ijk) * this->dt;
-
-    tmp1(ijk) = r_c(ijk);
-    // fill halos for gradient calculation
-    // TODO: no need to xchng in horizontal, which potentially causes MPI communication
-    this->xchng_sclr(tmp1, this->ijk, this->halo);
-    this->vert_grad_cnt(tmp1, F, params.dz);
-    F(ijk).reindex(this->zero) *= - (*params.w_LS)(this->vert_idx);
-    r_c(ijk) += F(ijk) * this->dt;
-  }
+    this->subsidence_apply({this->r_l, r_c}, this->dt);
 
   // advect r_l and r_c (1st-order)
   this->self_advec_donorcell(this->r_l);
@@ -14,8 +14,8 @@
  *    initial SD concentration, dry size distributions, and relaxation sources.
  *    Special adjustments are made for large tails, multiple CUDA devices, or distributed memory.
  * 4. Creates the `prtcls` (super-droplet) object using the `libcloudphxx::lgrngn` factory.
- * 5. Initializes temporary arrays for air density (`rhod`) and pressure (`p_e`) to allow
- *    super-droplet initialization over a 1D profile.
+ * 5. Describes the 1D air density (`rhod`) and pressure (`p_e`) profiles as arrays with
+ *    zero horizontal strides, so that no full-domain temporaries are needed.
  * 6. Calls `prtcls->init()` to initialize the particle arrays with the thermodynamic
  *    and microphysical state.
  * 7. Records microphysics configuration parameters.
@@ -62,19 +62,7 @@ void slvr_lgrngn<ct_params_t>::hook_ante_loop(int nt)
     else
       params.cloudph_opts_init.x1 =  params.cloudph_opts_init.nx       * this->di;
 
-    int n_sd_from_dry_sizes = 0;
-    for (auto const& krcm : params.cloudph_opts_init.dry_sizes)
-      for (auto const& rcm : krcm.second)
-        n_sd_from_dry_sizes += rcm.second.second;
-
-    // src_dry_distros is used only in the first step to add GCCN below some level
-    //int n_sd_from_src_dry_distros = params.cloudph_opts.src_sd_conc * params.cloudph_opts_init.src_z1 / params.cloudph_opts_init.z1 + 0.5;
-    int n_sd_from_src_dry_distros = 0;
-    for (auto const& kv : params.cloudph_opts.src_dry_distros)
-      n_sd_from_src_dry_distros += std::get<1>(kv.second); // src_sd_conc
-    n_sd_from_src_dry_distros *= params.cloudph_opts_init.src_z1 / params.cloudph_opts_init.z1;
-
-    const int n_sd_per_cell = params.cloudph_opts_init.sd_conc + n_sd_from_dry_sizes + n_sd_from_src_dry_distros;
+    const int n_sd_per_cell = calc_n_sd_per_cell(params);
 
     if(parent_t::n_dims == 2) // 2D
     {
@@ -82,19 +70,6 @@ void slvr_lgrngn<ct_params_t>::hook_ante_loop(int nt)
       params.cloudph_opts_init.dz = this->dj;
       params.cloudph_opts_init.z0 = this->dj / 2;
       params.cloudph_opts_init.z1 = (params.cloudph_opts_init.nz - .5) * this->dj;
-
-      if(params.cloudph_opts_init.sd_conc)
-      {
-        if(params.cloudph_opts_init.sd_conc_large_tail)
-          params.cloudph_opts_init.n_sd_max = 1.2 * params.cloudph_opts_init.nx * params.cloudph_opts_init.nz * n_sd_per_cell; // 1.2 to make space for large tail
-        else
-          params.cloudph_opts_init.n_sd_max = params.cloudph_opts_init.nx * params.cloudph_opts_init.nz * n_sd_per_cell;
-      }
-      else
-        params.cloudph_opts_init.n_sd_max = 1.2 * params.cloudph_opts_init.nx * params.cloudph_opts_init.nz * 1.e8 * params.cloudph_opts_init.dx * params.cloudph_opts_init.dz / params.cloudph_opts_init.sd_const_multi; // NOTE: hardcoded N_a=100/cm^3 !!
-        
-      if(params.backend == libcloudphxx::lgrngn::multi_CUDA || this->mem->distmem.size()>1)
-        params.cloudph_opts_init.n_sd_max *= 1.4; // more space for copied SDs
     }
     else // 3D
     {
@@ -107,46 +82,35 @@ void slvr_lgrngn<ct_params_t>::hook_ante_loop(int nt)
       params.cloudph_opts_init.dz = this->dk;
       params.cloudph_opts_init.z0 = this->dk / 2;
       params.cloudph_opts_init.z1 = (params.cloudph_opts_init.nz - .5) * this->dk;
-
-      if(params.cloudph_opts_init.sd_conc)
-      {
-        if(params.cloudph_opts_init.sd_conc_large_tail)
-          params.cloudph_opts_init.n_sd_max = 1.2 * params.cloudph_opts_init.nx * params.cloudph_opts_init.ny * params.cloudph_opts_init.nz * n_sd_per_cell; // 1.2 to make space for large tail
-        else
-          params.cloudph_opts_init.n_sd_max =       params.cloudph_opts_init.nx * params.cloudph_opts_init.ny * params.cloudph_opts_init.nz * n_sd_per_cell; 
-      }
-      else
-        params.cloudph_opts_init.n_sd_max = 1.2 * params.cloudph_opts_init.nx * params.cloudph_opts_init.ny * params.cloudph_opts_init.nz * 1.e8 * params.cloudph_opts_init.dx * params.cloudph_opts_init.dy * params.cloudph_opts_init.dz / params.cloudph_opts_init.sd_const_multi; // hardcoded N_a=100/cm^3 !!
-
-      if(params.backend == libcloudphxx::lgrngn::multi_CUDA || this->mem->distmem.size()>1)
-        params.cloudph_opts_init.n_sd_max *= 1.3; // more space for copied SDs
     }
 
     params.cloudph_opts_init.rlx_sd_per_bin /= this->mem->distmem.size();
 
-    // space for SD created via relaxation, impossible to know exactly how many will be added, because it depends on washout of SD...
-    int n_sd_from_rlx_dry_distros = params.cloudph_opts_init.rlx_sd_per_bin * params.cloudph_opts_init.rlx_bins * params.cloudph_opts_init.nz * 100; // room for 100 rounds of full relaxation... 
-    params.cloudph_opts_init.n_sd_max += n_sd_from_rlx_dry_distros;
+    params.cloudph_opts_init.n_sd_max = calc_n_sd_max(params.cloudph_opts_init, n_sd_per_cell,
+      params.backend == libcloudphxx::lgrngn::multi_CUDA || this->mem->distmem.size()>1);
 
     prtcls.reset(libcloudphxx::lgrngn::factory<real_t>(
       (libcloudphxx::lgrngn::backend_t)params.backend, 
       params.cloudph_opts_init
     ));
 
-    // temporary array of densities - prtcls cant be init'd with 1D profile
-    typename parent_t::arr_t rhod(this->mem->advectee(ix::th).shape()); // TODO: replace all rhod arrays with this->mem->G
-    rhod = (*params.rhod)(this->vert_idx);
-
-    // temporary array of pressure - prtcls cant be init'd with 1D profile
-    typename parent_t::arr_t p_e(this->mem->advectee(ix::th).shape()); 
-    p_e = (*params.p_e)(this->vert_idx);
+    // 1D profiles of density and pressure seen by prtcls as n_dims arrays with zero horizontal strides,
+    // i.e. no full-domain temporaries are allocated
+    blitz::TinyVector<blitz::diffType, parent_t::n_dims> prof_strides(0);
+    prof_strides(parent_t::n_dims - 1) = 1;
 
     prtcls->init(
       make_arrinfo(this->mem->advectee(ix::th)),
       make_arrinfo(this->mem->advectee(ix::rv)),
-      make_arrinfo(rhod)
-      ,make_arrinfo(p_e)
+      libcloudphxx::lgrngn::arrinfo_t<real_t>(params.rhod->data(), prof_strides.data()),
+      libcloudphxx::lgrngn::arrinfo_t<real_t>(params.p_e->data(), prof_strides.data())
     ); 
+
+    // not measurable, estimated with the per-SD memory as in --estimate (sd_bytes, see slvr_lgrngn.hpp)
+    detail::mem_ledger().add(__FILE__, "super-droplets (estimate for n_sd_max = " + std::to_string(params.cloudph_opts_init.n_sd_max) + ")",
+      (unsigned long long)(params.cloudph_opts_init.n_sd_max) * sd_bytes);
+    detail::mem_ledger().add(__FILE__, "libcloudph++ output buffer (outbuf)",
+      (unsigned long long)(params.cloudph_opts_init.nx) * std::max(1, params.cloudph_opts_init.ny) * params.cloudph_opts_init.nz * sizeof(real_t));
   }
   this->mem->barrier();
   parent_t::hook_ante_loop(nt); 
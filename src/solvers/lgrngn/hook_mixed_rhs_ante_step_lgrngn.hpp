@@ -13,7 +13,7 @@ void slvr_lgrngn<ct_params_t>::hook_mixed_rhs_ante_step()
   rv_pre_cond(this->ijk) = this->state(ix::rv)(this->ijk); 
   th_pre_cond(this->ijk) = this->state(ix::th)(this->ijk); 
 
-  this->mem->barrier();
+  this->barrier_at("hook_mixed_rhs_ante_step: pre_cond copies");
 
   // pass Eulerian fields to microphysics 
   if (this->rank == 0) 
@@ -42,6 +42,7 @@ void slvr_lgrngn<ct_params_t>::hook_mixed_rhs_ante_step()
       diag_prev_step == 0    // ... and not after diag call
     ) {
       assert(ftr.valid());
+      detail::prof_scope_t prof_scope(params.prof, this->rank, detail::prof_async_wait);
 #if defined(UWLCM_TIMING)
       tbeg = setup::clock::now();
 #endif
@@ -73,6 +74,7 @@ void slvr_lgrngn<ct_params_t>::hook_mixed_rhs_ante_step()
 #if defined(UWLCM_TIMING)
     tbeg = setup::clock::now();
 #endif
+    detail::prof_scope_t prof_scope(params.prof, this->rank, detail::prof_micro);
 
     using libcloudphxx::lgrngn::particles_t;
     using libcloudphxx::lgrngn::CUDA;
@@ -131,7 +133,7 @@ void slvr_lgrngn<ct_params_t>::hook_mixed_rhs_ante_step()
     parent_t::tsync += std::chrono::duration_cast<setup::timer>( tend - tbeg );
 #endif
   }
-  this->mem->barrier();
+  this->barrier_at("hook_mixed_rhs_ante_step: sync_in and step_cond");
 
   parent_t::hook_mixed_rhs_ante_step();
 }
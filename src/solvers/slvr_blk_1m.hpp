@@ -54,9 +54,11 @@ class slvr_blk_1m<
   ) {
     parent_t::update_rhs(rhs, dt, at); // shouldnt forcings be after condensation to be consistent with lgrngn solver?
 
-    this->mem->barrier();
+    this->barrier_at("update_rhs blk_1m: before columnwise");
     if(at == 0)
     {
+      detail::prof_scope_t prof_scope(this->params.prof, this->rank, detail::prof_micro);
+
       // column-wise
       for (int i = this->i.first(); i <= this->i.last(); ++i)
       {
@@ -72,7 +74,7 @@ class slvr_blk_1m<
       rhs.at(parent_t::ix::rr)(this->ijk) += this->precipitation_rate(this->ijk);
 
       nancheck(rhs.at(parent_t::ix::rr)(this->ijk), "RHS of rr after rhs_update");
-      this->mem->barrier();
+      this->barrier_at("update_rhs blk_1m: after columnwise");
     }
   }
 };
@@ -124,9 +126,11 @@ class slvr_blk_1m<
   ) {
     parent_t::update_rhs(rhs, dt, at); // shouldnt forcings be after condensation to be consistent with lgrngn solver?
 
-    this->mem->barrier();
+    this->barrier_at("update_rhs blk_1m: before columnwise");
     if(at == 0)
     {
+      detail::prof_scope_t prof_scope(this->params.prof, this->rank, detail::prof_micro);
+
       // column-wise
       for (int i = this->i.first(); i <= this->i.last(); ++i)
         for (int j = this->j.first(); j <= this->j.last(); ++j)
@@ -143,7 +147,7 @@ class slvr_blk_1m<
       rhs.at(parent_t::ix::rr)(this->ijk) += this->precipitation_rate(this->ijk);
 
       nancheck(rhs.at(parent_t::ix::rr)(this->ijk), "RHS of rr after rhs_update");
-      this->mem->barrier();
+      this->barrier_at("update_rhs blk_1m: after columnwise");
     }
   }
 };
@@ -57,9 +57,11 @@ class slvr_blk_2m<
   ) {
     parent_t::update_rhs(rhs, dt, at);
 
-    this->mem->barrier();
+    this->barrier_at("update_rhs blk_2m: before columnwise");
     if(at == 0)
     {
+      detail::prof_scope_t prof_scope(this->params.prof, this->rank, detail::prof_micro);
+
       // column-wise
       for (int i = this->i.first(); i <= this->i.last(); ++i)
       {
@@ -131,9 +133,11 @@ class slvr_blk_2m<
   ) {
     parent_t::update_rhs(rhs, dt, at);
 
-    this->mem->barrier();
+    this->barrier_at("update_rhs blk_2m: before columnwise");
     if(at == 0)
     {
+      detail::prof_scope_t prof_scope(this->params.prof, this->rank, detail::prof_micro);
+
       // column-wise
       for (int i = this->i.first(); i <= this->i.last(); ++i)
         for (int j = this->j.first(); j <= this->j.last(); ++j)
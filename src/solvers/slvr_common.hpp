@@ -2,11 +2,19 @@
 #include "../cases/CasesCommon.hpp"
 #include "slvr_dim.hpp"
 #include <chrono>
+#include <initializer_list>
+#include <algorithm>
 #include <libmpdata++/git_revision.hpp>
 #include <libcloudph++/git_revision.h>
 #include <libcloudph++/common/output.hpp>
 #include "../detail/get_uwlcm_git_revision.hpp"
 #include "../detail/ForceParameters.hpp"
+#include "../detail/blitz_hlpr_fctrs.hpp"
+#include "../detail/hrzntl_sums.hpp"
+#include "../detail/profiler.hpp"
+#include "../detail/status.hpp"
+#include "../detail/mem_ledger.hpp"
+#include "../detail/estimate.hpp"
 #include <boost/asio/ip/host_name.hpp>
 
 struct smg_tag  {};
@@ -67,9 +75,42 @@ class slvr_common : public slvr_dim<ct_params_t>
                            &radiative_flux,
                            &diss_rate; // TODO: move to slvr_sgs to save memory in iles simulations !;
 
-  setup::arr_1D_t th_mean_prof, rv_mean_prof; // profiles with mean th/rv at each level
-                                              // NOTE: these profiles hold the same values for all threads (and MPI processes),
-                                              //       but each thread has it's own copy. We could have one per MPI process to save memory
+  // buoyancy, see w_src(); a view of F, unless the solver can reuse it (see th_kept_between_steps()) and gives it an own array
+  typename parent_t::arr_t buoy;
+
+  // buoyancy at n+1 is reused at n of the next timestep if th, rv and r_l are not modified in between
+  bool buoy_reuse = false, // set in hook_ante_loop
+       buoy_valid = false; // buoy holds buoyancy of the current state
+
+  // number of halo exchanges started from UWLCM code by this thread (those inside libmpdata++, e.g. in advection, are not counted),
+  // reported by exec_timer
+  unsigned long n_xchng = 0;
+
+  // horizontal mean profiles of state fields, all computed in one batch at the start of update_rhs(at=0), see calc_mean_profs()
+  // NOTE: these profiles hold the same values for all threads (and MPI processes),
+  //       but each thread has it's own copy. We could have one per MPI process to save memory
+  std::vector<int> mean_prof_ixs;            // the fields, registered with add_mean_prof() in ctors
+  blitz::Array<setup::real_t, 2> mean_profs; // (position in mean_prof_ixs, level)
+  std::vector<std::pair<typename parent_t::arr_t, setup::arr_1D_t>> mean_prof_flds; // reused by calc_mean_profs()
+  setup::arr_1D_t th_mean_prof, rv_mean_prof; // profiles with mean th/rv at each level (rows of mean_profs if registered)
+
+  // per-level coefficients combining reference profiles, see init_prof_coeffs()
+  setup::arr_1D_t hgt_rhod_fctr,       // hgt_fctr / rhod, surface flux of rv or momentum -> tendency
+                  hgt_rhod_exner_fctr, // hgt_fctr / rhod / exner, surface flux of th -> tendency
+                  rhod_exner_inv,      // 1 / (rhod * exner), heating -> c_p * tendency of th
+                  exner_inv;           // 1 / exner
+
+  // per-thread buffers of subsidence of the mean, see subsidence_mean()
+  setup::arr_1D_t subs_mean, subs_grad, subs_prof;
+
+  // fused sum of rv/th sources, see sum_src()
+  setup::arr_1D_t lvl_src,                       // sum of sources that depend only on height
+                  srfc_lat_fctr, srfc_sens_fctr, // per-level factors converting surface fluxes into tendencies (references to the coefficients above or to zero_prof)
+                  zero_prof;
+  typename parent_t::arr_t zero_src, rad_src, subs_src, srfc_lat_src, srfc_sens_src; // 2D/3D views set in set_src_views()
+
+  // radiation: column buffers and tables of the free-atmosphere term, see init_radiation()
+  setup::arr_1D_t rad_tau_up, rad_tau_dn, rad_fa_43, rad_fa_13;
 
   // precip output
   std::map<cmn::output_t, real_t> puddle;
@@ -94,6 +135,10 @@ class slvr_common : public slvr_dim<ct_params_t>
   
   virtual void sgs_scalar_forces(const std::vector<int>&) {}
   virtual typename parent_t::arr_t get_rc(typename parent_t::arr_t&) = 0;
+  // is th left unchanged between the end of a timestep and the start of the next one (no microphysics)
+  virtual bool th_kept_between_steps() {return false;}
+  // are there heap allocations in timesteps after the first one (e.g. in libcloudph++), see exec_timer
+  virtual bool allocs_in_step() {return false;}
 
   //void common_water_src(int, int);
 
@@ -110,6 +155,17 @@ class slvr_common : public slvr_dim<ct_params_t>
     else
       set_rain(true);
 
+    // before parent hook, as it may already compute the rhs
+    if(this->rank == 0)
+      params.hrzntl_sums->resize(this->mem->size, this->vert_rng.length());
+    this->mem->barrier();
+    init_mean_profs();
+    init_prof_coeffs();
+    set_src_views();
+    if(params.radiation)
+      init_radiation();
+    buoy_reuse = params.user_params.reuse_buoyancy && !params.buoyancy_wet && th_kept_between_steps();
+
     parent_t::hook_ante_loop(nt);
 
     // record user_params and profiles
@@ -156,6 +212,7 @@ class slvr_common : public slvr_dim<ct_params_t>
       this->record_aux_const("rng_seed_init", "user_params", params.user_params.rng_seed_init);  
       this->record_aux_const("sgs_delta", "user_params", params.user_params.sgs_delta);  
       this->record_aux_const("relax_th_rv", "user_params", params.user_params.relax_th_rv);  
+      this->record_aux_const("reuse_buoyancy", "user_params", params.user_params.reuse_buoyancy);  
       this->record_aux_const("case_n_stp_multiplier", "user_params", params.user_params.case_n_stp_multiplier);  
       this->record_aux_const("window", "user_params", params.user_params.window);  
 
@@ -278,18 +335,229 @@ class slvr_common : public slvr_dim<ct_params_t>
   template<int n_dims>
   blitz::TinyVector<int, n_dims> base(const idx_t<n_dims> &rng) { return rng.lbound();}
 
+  // a 2D/3D read-only view of a vertical profile over the ijk subdomain,
+  // zero horizontal strides, i.e. all columns point to the profile data - no per-cell copy is stored;
+  // use only as an operand of blitz expressions, blitz iterators (e.g. in libcloudph++ cellwise routines) do not handle zero strides
+  typename parent_t::arr_t vert_prof_view(const setup::arr_1D_t &prof)
+  {
+    constexpr int n_dims = parent_t::n_dims;
+    blitz::TinyVector<blitz::diffType, n_dims> strides(0);
+    strides(n_dims - 1) = prof.stride(0);
+    typename parent_t::arr_t view(
+      const_cast<real_t*>(&prof(this->ijk.lbound(n_dims - 1))),
+      this->shape(this->ijk),
+      strides,
+      blitz::neverDeleteData
+    );
+    view.reindexSelf(this->base(this->ijk));
+    return view;
+  }
+
+  // a 2D/3D read-only view of a surface array over the ijk subdomain,
+  // zero vertical stride, i.e. all levels point to the surface values; as vert_prof_view, only for blitz expressions
+  typename parent_t::arr_t srfc_view(const typename parent_t::arr_t &srfc)
+  {
+    constexpr int n_dims = parent_t::n_dims;
+    blitz::TinyVector<int, n_dims> ground = this->base(this->ijk);
+    ground(n_dims - 1) = 0;
+    blitz::TinyVector<blitz::diffType, n_dims> strides = srfc.stride();
+    strides(n_dims - 1) = 0;
+    typename parent_t::arr_t view(
+      const_cast<real_t*>(&srfc(ground)),
+      this->shape(this->ijk),
+      strides,
+      blitz::neverDeleteData
+    );
+    view.reindexSelf(this->base(this->ijk));
+    return view;
+  }
+
+  /**
+   * @brief Horizontal means at each level of several fields.
+   *
+   * Each thread sums its subdomain column by column, then there is one reduction over threads
+   * and one MPI collective for all levels of all fields. Has to be called by all threads.
+   *
+   * @param fields Pairs of a field and a 1D array (shallow copy) that receives its mean profile.
+   */
+  template <class flds_t>
+  void hrzntl_means(const flds_t &fields)
+  {
+    auto &sums = *params.hrzntl_sums;
+    const int nz = this->vert_rng.length(),
+              n = fields.size() * nz;
+    assert(fields.size() <= detail::hrzntl_sums_t::n_fields_max);
+
+    double *acc = &sums.partial(this->rank, 0);
+    std::fill(acc, acc + n, 0.);
+    int f = 0;
+    for(const auto &fld : fields)
+      this->hrzntl_level_sums(fld.first, acc + nz * f++);
+
+    this->barrier_at("hrzntl_means: partial sums");
+    if(this->rank == 0)
+    {
+      for(int c = 0; c < n; ++c)
+      {
+        sums.total[c] = 0;
+        for(int r = 0; r < this->mem->size; ++r)
+          sums.total[c] += sums.partial(r, c);
+      }
+      detail::distmem_sum(sums.total.data(), n);
+    }
+    this->barrier_at("hrzntl_means: total sums");
+
+    f = 0;
+    for(const auto &fld : fields)
+    {
+      auto res = fld.second; // shallow copy
+      for(int k = 0; k < nz; ++k)
+        res(k) = sums.total[f * nz + k] / this->n_cell_per_level;
+      ++f;
+    }
+  }
+
+  void hrzntl_means(std::initializer_list<std::pair<typename parent_t::arr_t, setup::arr_1D_t>> fields)
+  {
+    hrzntl_means<decltype(fields)>(fields);
+  }
+
+  /**
+   * @brief Barrier with the time spent waiting in it recorded by the profiler (if on).
+   *
+   * @param site Name of the barrier, reported with the name of the previous barrier of the thread.
+   */
+  void barrier_at(const char *site)
+  {
+    if(params.prof == nullptr || !params.prof->enabled())
+    {
+      this->mem->barrier();
+      return;
+    }
+    const auto tarr = detail::profiler_t::clock::now();
+    this->mem->barrier();
+    params.prof->barrier(this->rank, site, tarr, detail::profiler_t::clock::now());
+  }
+
+  /**
+   * @brief Edge averaging (avg_edge_sclr) of several scalars with one pair of barriers.
+   *
+   * @param arrs Scalars (shallow copies).
+   */
+  void avg_edge_sclrs(std::initializer_list<typename parent_t::arr_t> arrs)
+  {
+    detail::prof_scope_t prof_scope(params.prof, this->rank, detail::prof_xchng);
+    this->barrier_at("avg_edge_sclrs: before");
+    for(auto arr : arrs)
+    {
+      ++n_xchng;
+      this->avg_edge_sclr_nobarrier(arr, this->ijk);
+    }
+    this->barrier_at("avg_edge_sclrs: after");
+  }
+
+  // registers a state field whose horizontal mean profile is needed in update_rhs(at=0), to be called in ctors
+  void add_mean_prof(const int type)
+  {
+    if(std::find(mean_prof_ixs.begin(), mean_prof_ixs.end(), type) == mean_prof_ixs.end())
+      mean_prof_ixs.push_back(type);
+  }
+
+  // position of the mean profile of a state field in mean_profs, -1 if it is not registered
+  int mean_prof_idx(const int type) const
+  {
+    const auto it = std::find(mean_prof_ixs.begin(), mean_prof_ixs.end(), type);
+    return it == mean_prof_ixs.end() ? -1 : it - mean_prof_ixs.begin();
+  }
+
+  void init_mean_profs()
+  {
+    mean_profs.resize(mean_prof_ixs.size(), this->vert_rng.length());
+    mean_prof_flds.reserve(mean_prof_ixs.size());
+    if(mean_prof_idx(ix::th) >= 0)
+      th_mean_prof.reference(mean_profs(mean_prof_idx(ix::th), blitz::Range::all()));
+    if(mean_prof_idx(ix::rv) >= 0)
+      rv_mean_prof.reference(mean_profs(mean_prof_idx(ix::rv), blitz::Range::all()));
+  }
+
+  // mean profiles of all registered fields, with one reduction
+  void calc_mean_profs()
+  {
+    if(mean_prof_ixs.empty()) return;
+    mean_prof_flds.clear();
+    for(std::size_t m = 0; m < mean_prof_ixs.size(); ++m)
+      mean_prof_flds.emplace_back(this->state(mean_prof_ixs[m]), mean_profs(m, blitz::Range::all()));
+    hrzntl_means(mean_prof_flds);
+  }
+
+  // per-level coefficients that depend only on the reference profiles, these do not change during the simulation,
+  // so they are computed once (needs to be called again if profiles are modified) and forcings apply them with one multiply per cell
+  void init_prof_coeffs()
+  {
+    blitz::firstIndex k;
+    const int nz = this->vert_rng.length();
+    hgt_rhod_fctr.resize(nz);
+    hgt_rhod_exner_fctr.resize(nz);
+    rhod_exner_inv.resize(nz);
+    exner_inv.resize(nz);
+
+    exner_inv = 1. / calc_exner()((*params.p_e)(k));
+    rhod_exner_inv = exner_inv(k) / (*params.rhod)(k);
+    hgt_rhod_fctr = (*params.hgt_fctr)(k) / (*params.rhod)(k);
+    hgt_rhod_exner_fctr = hgt_rhod_fctr * exner_inv;
+  }
+
+  // choose what is summed by sum_src(); disabled terms point to zeros and are not recomputed each step
+  void set_src_views()
+  {
+    const auto &ijk = this->ijk;
+
+    zero_src.reference(this->vert_prof_view(zero_prof));
+
+    // heating rate computed in alpha, radiative flux stays zero if there is no radiation
+    if(params.radiation)
+      rad_src.reference(alpha(ijk));
+    else
+    {
+      rad_src.reference(zero_src);
+      radiative_flux(ijk) = 0.;
+    }
+
+    // local subsidence computed in F, subsidence of the mean is a per-level source
+    if(params.subsidence == subs_t::local)
+      subs_src.reference(F(ijk));
+    else
+      subs_src.reference(zero_src);
+
+    // in SMG surface fluxes are applied via SGS fluxes
+    if(ct_params_t::sgs_scheme == libmpdataxx::solvers::iles)
+    {
+      srfc_lat_src.reference(this->srfc_view(surf_flux_lat));
+      srfc_sens_src.reference(this->srfc_view(surf_flux_sens));
+      srfc_lat_fctr.reference(hgt_rhod_fctr);
+      srfc_sens_fctr.reference(hgt_rhod_exner_fctr);
+    }
+    else
+    {
+      srfc_lat_src.reference(zero_src);
+      srfc_sens_src.reference(zero_src);
+      srfc_lat_fctr.reference(zero_prof);
+      srfc_sens_fctr.reference(zero_prof);
+    }
+
+    // no implicit part of rv and th sources
+    beta(ijk) = 0.;
+  }
+
+  void sum_src(const typename parent_t::arr_t &rad, const typename parent_t::arr_t &srfc, const setup::arr_1D_t &srfc_fctr, const setup::arr_1D_t &lvl);
+
   void buoyancy(typename parent_t::arr_t &th, typename parent_t::arr_t &rv);
+  void init_radiation();
   void radiation(typename parent_t::arr_t &rv);
   void rv_src();
   void th_src(typename parent_t::arr_t &rv);
   void w_src(typename parent_t::arr_t &th, typename parent_t::arr_t &rv, const int at);
 
-  void surf_sens_impl(smg_tag);
-  void surf_sens_impl(iles_tag);
-
-  void surf_latent_impl(smg_tag);
-  void surf_latent_impl(iles_tag);
-
   void surf_u_impl(smg_tag);
   void surf_u_impl(iles_tag);
 
@@ -302,11 +570,13 @@ class slvr_common : public slvr_dim<ct_params_t>
   void surf_v();
 
   void subsidence(const int&);
+  void subsidence_mean(const int&, setup::arr_1D_t&);
+  void subsidence_apply(std::initializer_list<typename parent_t::arr_t>, const real_t&);
   void coriolis(const int&);
-  void relax_th_rv(const int&);
+  void relax_th_rv(const int&, setup::arr_1D_t&);
 
-  void rv_LS();
-  void th_LS();
+  void rv_LS(setup::arr_1D_t&);
+  void th_LS(setup::arr_1D_t&);
 
   /**
  * @brief Update RHS terms.
@@ -320,8 +590,10 @@ class slvr_common : public slvr_dim<ct_params_t>
     const int &at
   )
   {
+    detail::prof_scope_t prof_scope(params.prof, this->rank, detail::prof_forcings);
+
     parent_t::update_rhs(rhs, dt, at); // zero-out rhs
-    this->mem->barrier();
+    this->barrier_at("update_rhs: rhs zeroed");
 
     using ix = typename ct_params_t::ix;
 
@@ -336,12 +608,8 @@ class slvr_common : public slvr_dim<ct_params_t>
         // calculate surface wind magnitude, TODO: not needed if there are no surface fluxes
         U_ground(this->hrzntl_slice(0)) = this->calc_U_ground();
 
-        // calculate mean th and rv at each level, needed for nudging of the horizontal mean
-        if(params.user_params.relax_th_rv)
-        {
-          this->hrzntl_mean(this->state(ix::rv), rv_mean_prof);
-          this->hrzntl_mean(this->state(ix::th), th_mean_prof);
-        }
+        // calculate mean profiles needed for nudging of the horizontal mean and for subsidence of the mean
+        calc_mean_profs();
 
         // ---- water vapor sources ----
         rv_src();
@@ -449,7 +717,7 @@ class slvr_common : public slvr_dim<ct_params_t>
     nancheck(rhs.at(ix::w)(this->ijk), "RHS of w after rhs_update");
     for(auto type : this->hori_vel)
       {nancheck(rhs.at(type)(this->ijk), (std::string("RHS of horizontal velocity after rhs_update, type: ") + std::to_string(type)).c_str());}
-    this->mem->barrier();
+    this->barrier_at("update_rhs: forcings");
   }
 
 
@@ -460,7 +728,7 @@ class slvr_common : public slvr_dim<ct_params_t>
 
     if(!params.friction) return;
 
-    this->mem->barrier();
+    this->barrier_at("vip_rhs_expl_calc: before friction");
     if(this->rank == 0)
       tbeg = clock::now();
     // kinematic momentum flux  = -u_fric^2 * u_i / |U| * exponential decay
@@ -481,7 +749,7 @@ class slvr_common : public slvr_dim<ct_params_t>
 
     for(int it = 0; it < parent_t::n_dims-1; ++it)
       {nancheck(this->vip_rhs[it](this->ijk), (std::string("vip_rhs after vip_rhs_expl_calc type: ") + std::to_string(it)).c_str());} 
-    this->mem->barrier();
+    this->barrier_at("vip_rhs_expl_calc: after friction");
     if(this->rank == 0)
     {
       tend = clock::now();
@@ -497,7 +765,7 @@ class slvr_common : public slvr_dim<ct_params_t>
   {
     negtozero(this->mem->advectee(ix::rv)(this->ijk), "rv at start of slvr_common::hook_post_step");
     parent_t::hook_post_step(); // includes output
-    this->mem->barrier();
+    this->barrier_at("hook_post_step: after output");
     negcheck(this->mem->advectee(ix::rv)(this->ijk), "rv at end of slvr_common::hook_post_step");
   }
 
@@ -550,12 +818,14 @@ class slvr_common : public slvr_dim<ct_params_t>
     this->record_aux_prof("rv_LS", params.rv_LS->data());
     this->record_aux_prof("th_LS", params.th_LS->data());
 
+    // sum puddle over MPI processes, one collective for all scalars
     get_puddle();
+    std::vector<real_t> puddle_sum(n_puddle_scalars);
     for(int i=0; i < n_puddle_scalars; ++i)
-    {
-      real_t sum = this->mem->distmem.sum(puddle.at(static_cast<cmn::output_t>(i)));
-      this->record_aux_scalar(cmn::output_names.at(static_cast<cmn::output_t>(i)), "puddle", sum);
-    }
+      puddle_sum[i] = puddle.at(static_cast<cmn::output_t>(i));
+    detail::distmem_sum(puddle_sum.data(), n_puddle_scalars);
+    for(int i=0; i < n_puddle_scalars; ++i)
+      this->record_aux_scalar(cmn::output_names.at(static_cast<cmn::output_t>(i)), "puddle", puddle_sum[i]);
   } 
 
   /**
@@ -583,6 +853,9 @@ class slvr_common : public slvr_dim<ct_params_t>
   {
     subs_t subsidence = subs_t::none; // local - subsidence computed in each column, mean - subsidence of the horizontal mean; NOTE: subsidence of SDs is done locally both for 'mean' and for 'local'! 
     bool rv_src = true, th_src = true, uv_src = true, w_src = true;
+    detail::hrzntl_sums_t *hrzntl_sums = nullptr; // buffers for horizontal means, shared among threads
+    detail::profiler_t *prof = nullptr; // timings of code regions, shared among threads
+    detail::status_t *status = nullptr; // progress of the run in outdir/status.json, nullptr if not written
     bool coriolis = false, 
          friction = false, 
          buoyancy_wet = false, 
@@ -626,7 +899,8 @@ class slvr_common : public slvr_dim<ct_params_t>
     U_ground(args.mem->tmp[__FILE__][1][3]),
     surf_flux_tmp(args.mem->tmp[__FILE__][1][4]),
     surf_flux_u(args.mem->tmp[__FILE__][1][5]),
-    surf_flux_v(args.mem->tmp[__FILE__][1][6]) // flux_v needs to be last
+    surf_flux_v(args.mem->tmp[__FILE__][1][6]), // flux_v needs to be last
+    buoy(F)
   {
     k_i.resize(this->shape(this->hrzntl_subdomain)); 
     k_i.reindexSelf(this->base(this->hrzntl_subdomain));
@@ -634,12 +908,54 @@ class slvr_common : public slvr_dim<ct_params_t>
     surf_flux_zero = 0.;
     th_mean_prof.resize(this->vert_rng.length());
     rv_mean_prof.resize(this->vert_rng.length());
+    if(p.user_params.relax_th_rv || p.subsidence == subs_t::mean)
+    {
+      add_mean_prof(ix::th);
+      add_mean_prof(ix::rv);
+    }
+    if(p.vel_subsidence && p.subsidence == subs_t::mean)
+    {
+      if(p.w_src && !ct_params_t::piggy)
+        add_mean_prof(ix::w);
+      if(p.uv_src)
+        for(const auto &type : this->hori_vel)
+          add_mean_prof(type);
+    }
+    lvl_src.resize(this->vert_rng.length());
+    zero_prof.resize(this->vert_rng.length());
+    zero_prof = 0.;
+    subs_mean.resize(this->vert_rng.length() + 1);
+    subs_grad.resize(this->vert_rng.length());
+    subs_prof.resize(this->vert_rng.length());
   }
 
+  // numbers of arrays allocated in alloc(), also counted by estimate()
+  static constexpr int n_tmp = 7,               // tmp1, r_l, F, alpha, beta, radiative_flux, diss_rate
+                       n_tmp_srfc = n_flxs + 3; // surf_flux sens/lat/hori_vel/zero/tmp, U_ground
+
+  // arrays of libmpdata++ are known only after allocation (the measured ones are listed in the calibration, see --estimate_steps),
+  // approximate count: advectees at two time levels and their rhs, scalars of the pressure solver (pressure, its error, the error
+  // of the previous iteration, its laplacian and four temporaries) and vectors of n_dims arrays (advector, antidiffusive advector
+  // of mpdata, extrapolated velocities at two time levels, pressure gradient and its temporary)
+  static constexpr int n_mpdata_sclr = 3 * ct_params_t::n_eqns + 8,
+                       n_mpdata_vctr = 6;
+
   static void alloc(typename parent_t::mem_t *mem, const int &n_iters)
   {
     parent_t::alloc(mem, n_iters);
-    parent_t::alloc_tmp_sclr(mem, __FILE__, 7); // tmp1, tmp2, r_l, alpha, beta, F, diss_rate, radiative_flux
-    parent_t::alloc_tmp_sclr(mem, __FILE__, n_flxs+3, "", true); // surf_flux sens/lat/hori_vel/zero/tmp, U_ground
+    parent_t::alloc_tmp_sclr(mem, __FILE__, n_tmp); // tmp1, r_l, F, alpha, beta, radiative_flux, diss_rate
+    detail::mem_ledger().add_tmp(mem, __FILE__, "tmp1, r_l, F, alpha, beta, radiative_flux, diss_rate");
+    parent_t::alloc_tmp_sclr(mem, __FILE__, n_tmp_srfc, "", true); // surf_flux sens/lat/hori_vel/zero/tmp, U_ground
+    detail::mem_ledger().add_tmp(mem, __FILE__, "surface fluxes, U_ground");
+  }
+
+  // arrays allocated in alloc() and fields written in diag(), without allocating anything (see --estimate)
+  static void estimate(detail::estimate_t &est, const rt_params_t &p)
+  {
+    est.arrays("libmpdata++", "advectees, rhs, advector, vip and pressure solver (approximate)", n_mpdata_sclr + n_mpdata_vctr * parent_t::n_dims);
+    est.arrays(__FILE__, "tmp1, r_l, F, alpha, beta, radiative_flux, diss_rate", n_tmp);
+    est.arrays(__FILE__, "surface fluxes, U_ground", n_tmp_srfc, true);
+    est.fields(p.outvars.size() + 1); // advectees and radiative_flux
+    est.fields(2, true); // sensible and latent surface flux
   }
 };
@@ -64,16 +64,32 @@ class slvr_dim<
   {
       return idx_t<2>({this->i, rng_t(k, k)});
   }
+
+  // columns of the subdomain of this thread, numbered 0 ... n_columns() - 1: horizontal position of column c
+  // and position of its bottom cell (for pointer access along the column, vertical stride of the array)
+  int n_columns() const { return this->i.length(); }
+  blitz::TinyVector<int, 1> column_hrzntl(const int c) const { return blitz::TinyVector<int, 1>(this->i.first() + c); }
+  blitz::TinyVector<int, 2> column(const int c) const { return blitz::TinyVector<int, 2>(this->i.first() + c, 0); }
+  // 1D view of column c of the subdomain, e.g. for libcloudph++ routines called column by column with vertical profiles
+  blitz::Array<setup::real_t, 1> column_view(const typename parent_t::arr_t &a, const int c) const { return a(this->i.first() + c, vert_rng); }
   
-  auto hrzntl_slice(const typename parent_t::arr_t &a, int k)
+  // add sums over the subdomain of this thread at each level to acc, column by column (vertical is the contiguous dimension)
+  void hrzntl_level_sums(const typename parent_t::arr_t &a, double *acc)
   {
-      return blitz::safeToReturn(a(idx_t<2>({this->i, rng_t(k, k)})) + 0);
+    const int nz = this->j.length();
+    const auto s = a.stride(1);
+    for(int i = this->i.first(); i <= this->i.last(); ++i)
+    {
+      const setup::real_t *col = &a(i, 0);
+      for(int k = 0; k < nz; ++k)
+        acc[k] += col[k * s];
+    }
   }
-  
-  void hrzntl_mean(const typename parent_t::arr_t &a, setup::arr_1D_t &res)
+
+  // avg_edge_sclr of libmpdata++ without barriers, for batches of scalars (see slvr_common::avg_edge_sclrs)
+  void avg_edge_sclr_nobarrier(typename parent_t::arr_t &arr, const idx_t<2> &range_ijk)
   {
-    for(int k=0; k<this->mem->distmem.grid_size[1]; ++k)
-      res(k) = this->mem->sum(this->rank, a, hrzntl_slice(k), false) / (this->mem->distmem.grid_size[0]);
+    for (auto &bc : this->bcs[0]) bc->avg_edge_and_halo1_sclr_cyclic(arr, range_ijk[1]);
   }
 
   void vert_grad_fwd(typename parent_t::arr_t in, typename parent_t::arr_t out, setup::real_t dz)
@@ -183,15 +199,44 @@ class slvr_dim<
       return idx_t<3>({this->i, this->j, rng_t(k, k)});
   }
 
-  auto hrzntl_slice(const typename parent_t::arr_t &a, int k)
+  // columns of the subdomain of this thread, numbered 0 ... n_columns() - 1: horizontal position of column c
+  // and position of its bottom cell (for pointer access along the column, vertical stride of the array)
+  int n_columns() const { return this->i.length() * this->j.length(); }
+  blitz::TinyVector<int, 2> column_hrzntl(const int c) const
   {
-      return blitz::safeToReturn(a(idx_t<3>({this->i, this->j, rng_t(k, k)})) + 0);
+    return blitz::TinyVector<int, 2>(this->i.first() + c / this->j.length(), this->j.first() + c % this->j.length());
   }
-  
-  void hrzntl_mean(const typename parent_t::arr_t &a, setup::arr_1D_t &res)
+  blitz::TinyVector<int, 3> column(const int c) const
+  {
+    const blitz::TinyVector<int, 2> pos = column_hrzntl(c);
+    return blitz::TinyVector<int, 3>(pos(0), pos(1), 0);
+  }
+  // 1D view of column c of the subdomain, e.g. for libcloudph++ routines called column by column with vertical profiles
+  blitz::Array<setup::real_t, 1> column_view(const typename parent_t::arr_t &a, const int c) const
+  {
+    const blitz::TinyVector<int, 2> pos = column_hrzntl(c);
+    return a(pos(0), pos(1), vert_rng);
+  }
+
+  // add sums over the subdomain of this thread at each level to acc, column by column (vertical is the contiguous dimension)
+  void hrzntl_level_sums(const typename parent_t::arr_t &a, double *acc)
+  {
+    const int nz = this->k.length();
+    const auto s = a.stride(2);
+    for(int i = this->i.first(); i <= this->i.last(); ++i)
+      for(int j = this->j.first(); j <= this->j.last(); ++j)
+      {
+        const setup::real_t *col = &a(i, j, 0);
+        for(int k = 0; k < nz; ++k)
+          acc[k] += col[k * s];
+      }
+  }
+
+  // avg_edge_sclr of libmpdata++ without barriers, for batches of scalars (see slvr_common::avg_edge_sclrs)
+  void avg_edge_sclr_nobarrier(typename parent_t::arr_t &arr, const idx_t<3> &range_ijk)
   {
-    for(int k=0; k<this->mem->distmem.grid_size[2]; ++k)
-      res(k) = this->mem->sum(this->rank, a, hrzntl_slice(k), false) / (this->mem->distmem.grid_size[0] * this->mem->distmem.grid_size[1]);
+    for (auto &bc : this->bcs[0]) bc->avg_edge_and_halo1_sclr_cyclic(arr, range_ijk[1], range_ijk[2]);
+    for (auto &bc : this->bcs[1]) bc->avg_edge_and_halo1_sclr_cyclic(arr, range_ijk[2], range_ijk[0]);
   }
 
   void vert_grad_fwd(typename parent_t::arr_t in, typename parent_t::arr_t out, setup::real_t dz)
@@ -40,6 +40,11 @@ class slvr_dry : public std::conditional_t<ct_params_t::sgs_scheme == libmpdatax
     return this->r_l; // r_l should be =0 in dry
   }
 
+  bool th_kept_between_steps() final
+  {
+    return true;
+  }
+
   void get_puddle() final
   {
     for(int i=0; i < this->n_puddle_scalars; ++i)
@@ -65,5 +70,30 @@ class slvr_dry : public std::conditional_t<ct_params_t::sgs_scheme == libmpdatax
 
   public:
 
-  using parent_t::parent_t;
+  // ctor
+  slvr_dry(
+    typename parent_t::ctor_args_t args,
+    const typename parent_t::rt_params_t &p
+  ) :
+    parent_t(args, p)
+  {
+    // buoyancy can be reused, so it is kept in an own array and not in F (see slvr_common::buoy_reuse)
+    this->buoy.reference(args.mem->tmp[__FILE__][0][0]);
+  }
+
+  // number of arrays allocated in alloc(), also counted by estimate()
+  static constexpr int n_tmp = 1; // buoy
+
+  static void alloc(typename parent_t::mem_t *mem, const int &n_iters)
+  {
+    parent_t::alloc(mem, n_iters);
+    parent_t::alloc_tmp_sclr(mem, __FILE__, n_tmp); // buoy
+    detail::mem_ledger().add_tmp(mem, __FILE__, "buoy");
+  }
+
+  static void estimate(detail::estimate_t &est, const typename parent_t::rt_params_t &p)
+  {
+    parent_t::estimate(est, p);
+    est.arrays(__FILE__, "buoy", n_tmp);
+  }
 };
@@ -52,24 +52,45 @@ class slvr_lgrngn : public std::conditional_t<ct_params_t::sgs_scheme == libmpda
   bool diag_prev_step; // flag saying if diag was done in the previous step
 
   /// @brief Diagnostic: update liquid water mixing ratio from superdroplets.
-  void diag_rl()
+  // copy third moment of wet radius of the selected SDs (per kg of dry air) [m^3 / kg] to arr, rank 0 only
+  void copy_wet_mom3(typename parent_t::arr_t arr)
   {
-    // fill with rl values from superdroplets
+    prtcls->diag_wet_mom(3);
+    auto arr_indomain = arr(this->domain); // arr refrences subdomain of arr
+    arr_indomain = typename parent_t::arr_t(prtcls->outbuf(), arr_indomain.shape(), blitz::duplicateData); // copy in data from outbuf
+  }
+
+  /// @brief Diagnostic: update liquid water mixing ratio (r_l) and, with SMG, cloud water mixing ratio (r_c) from superdroplets.
+  void diag_rl_rc()
+  {
+    constexpr bool with_rc = ct_params_t::sgs_scheme == libmpdataxx::solvers::smg;
+
+    // fill with rl and rc values from superdroplets
     if(this->rank == 0) 
     {
       prtcls->diag_all();
-      prtcls->diag_wet_mom(3);
-      auto r_l_indomain = this->r_l(this->domain); // rl refrences subdomain of r_l
-      r_l_indomain = typename parent_t::arr_t(prtcls->outbuf(), r_l_indomain.shape(), blitz::duplicateData); // copy in data from outbuf; total liquid third moment of wet radius per kg of dry air [m^3 / kg]
+      copy_wet_mom3(this->r_l); // total liquid
+      if(with_rc)
+      {
+        prtcls->diag_wet_rng(.5e-6, 25.e-6);
+        copy_wet_mom3(r_c);
+      }
     }
-    this->mem->barrier();
+    this->barrier_at("diag_rl_rc: moments");
 
     nancheck(this->r_l(this->ijk), "rl after copying from diag_wet_mom(3)");
     this->r_l(this->ijk) *= 4./3. * 1000. * 3.14159; // get mixing ratio [kg/kg]
-    this->mem->barrier();
+    if(with_rc)
+    {
+      nancheck(r_c(this->ijk), "r_c after copying from diag_wet_mom(3) in diag_rl_rc");
+      r_c(this->ijk) *= 4./3. * 1000. * 3.14159; // get mixing ratio [kg/kg]
+    }
 
-    // average values of rl in edge cells
-    this->avg_edge_sclr(this->r_l, this->ijk); // in case of cyclic bcond, rl on edges needs to be the same
+    // average values in edge cells, in case of cyclic bcond, rl and rc on edges need to be the same
+    if(with_rc)
+      this->avg_edge_sclrs({this->r_l, r_c});
+    else
+      this->avg_edge_sclrs({this->r_l});
   }
 
   /// @brief Get puddle water amount (overrides parent implementation).
@@ -114,30 +135,14 @@ class slvr_lgrngn : public std::conditional_t<ct_params_t::sgs_scheme == libmpda
     params.cloudph_opts.RH_max = val ? 44 : 1.01; // TODO: specify it somewhere else, dup in blk_2m
   };
   
-  /// @brief Diagnostic: update cloud water mixing ratio from superdroplets.
-  void diag_rc()
-  {
-    // fill with rc values from superdroplets
-    if(this->rank == 0) 
-    {
-      prtcls->diag_wet_rng(.5e-6, 25.e-6);
-      prtcls->diag_wet_mom(3);
-      auto rc = r_c(this->domain);
-      rc = typename parent_t::arr_t(prtcls->outbuf(), rc.shape(), blitz::duplicateData);
-    }
-    this->mem->barrier();
-
-    nancheck(r_c(this->ijk), "r_c after copying from diag_wet_mom(3) in diag_rc");
-    r_c(this->ijk) *= 4./3. * 1000. * 3.14159; // get mixing ratio [kg/kg]
-    this->mem->barrier();
-
-    this->avg_edge_sclr(r_c, this->ijk); // in case of cyclic bcond, rc on edges needs to be the same
-  }
-  
   virtual typename parent_t::arr_t get_rc(typename parent_t::arr_t& tmp) final
   {
     return r_c;
   }
+
+  // libcloudph++ allocates, e.g. when super-droplets are added by relaxation or sources
+  bool allocs_in_step() final {return true;}
+
   /// @brief Hook called before time loop starts.
   void hook_ante_loop(int nt);
   /// @brief Hook called before each time step.
@@ -150,9 +155,7 @@ class slvr_lgrngn : public std::conditional_t<ct_params_t::sgs_scheme == libmpda
   /// @brief Hook called before loop in mixed RHS solver (initial diagnostics).
   void hook_mixed_rhs_ante_loop()
   {
-    diag_rl(); // init r_l
-    if(ct_params_t::sgs_scheme == libmpdataxx::solvers::smg)
-      diag_rc(); // ditto
+    diag_rl_rc(); // init r_l (and r_c)
   } 
 
 #if defined(STD_FUTURE_WORKS)
@@ -174,6 +177,7 @@ class slvr_lgrngn : public std::conditional_t<ct_params_t::sgs_scheme == libmpda
     if (this->timestep > 0 && params.async)
     {
       assert(ftr.valid());
+      detail::prof_scope_t prof_scope(params.prof, this->rank, detail::prof_async_wait);
 #if defined(UWLCM_TIMING)
       parent_t::tasync_gpu += ftr.get();
 #else
@@ -235,6 +239,10 @@ class slvr_lgrngn : public std::conditional_t<ct_params_t::sgs_scheme == libmpda
     // TODO: equip rank() in libmpdata with an assert() checking if not in serial block
   }  
 
+  // numbers of arrays allocated in alloc(), also counted by estimate()
+  static constexpr int n_tmp_cond = 4, // rv_pre_cond, rv_post_cond, th_pre_cond, th_post_cond
+                       n_tmp_rc = 1;   // r_c
+
   /**
  * @brief Allocate memory for solver arrays.
  * @param mem memory manager
@@ -243,8 +251,118 @@ class slvr_lgrngn : public std::conditional_t<ct_params_t::sgs_scheme == libmpda
   static void alloc(typename parent_t::mem_t *mem, const int &n_iters)
   {
     parent_t::alloc(mem, n_iters);
-    parent_t::alloc_tmp_sclr(mem, __FILE__, 4);
-    parent_t::alloc_tmp_sclr(mem, __FILE__, 1);
+    parent_t::alloc_tmp_sclr(mem, __FILE__, n_tmp_cond);
+    detail::mem_ledger().add_tmp(mem, __FILE__, "rv_pre_cond, rv_post_cond, th_pre_cond, th_post_cond");
+    parent_t::alloc_tmp_sclr(mem, __FILE__, n_tmp_rc);
+    detail::mem_ledger().add_tmp(mem, __FILE__, "r_c");
+  }
+
+  // memory per SD in libcloudph++, used in --estimate and in the memory ledger (the buffers of libcloudph++ are not accessible,
+  // so it is counted from the per-SD vectors of its particles_t, approximately):
+  // - floating-point: 7 attributes (rw2, rd3, kpa, vt, x, y, z), 5 of ice and insoluble cores and 8 temporaries
+  //   (tmp_device_real_part* and the substepping ones),
+  // - integer (thrust_size_t, n_t): multiplicity n, cell indices i, j, k, ijk, sorted_id, sorted_ijk and 1 temporary
+  static constexpr int sd_n_real = 7 + 5 + 8,
+                       sd_n_int = 8;
+  static constexpr std::size_t sd_bytes = sd_n_real * sizeof(real_t) + sd_n_int * sizeof(unsigned long long);
+
+  // number of SDs per cell at initialization
+  static int calc_n_sd_per_cell(const rt_params_t &p)
+  {
+    int n_sd_from_dry_sizes = 0;
+    for (auto const& krcm : p.cloudph_opts_init.dry_sizes)
+      for (auto const& rcm : krcm.second)
+        n_sd_from_dry_sizes += rcm.second.second;
+
+    // src_dry_distros is used only in the first step to add GCCN below some level
+    //int n_sd_from_src_dry_distros = p.cloudph_opts.src_sd_conc * p.cloudph_opts_init.src_z1 / p.cloudph_opts_init.z1 + 0.5;
+    int n_sd_from_src_dry_distros = 0;
+    for (auto const& kv : p.cloudph_opts.src_dry_distros)
+      n_sd_from_src_dry_distros += std::get<1>(kv.second); // src_sd_conc
+    n_sd_from_src_dry_distros *= p.cloudph_opts_init.src_z1 / p.cloudph_opts_init.z1;
+
+    return p.cloudph_opts_init.sd_conc + n_sd_from_dry_sizes + n_sd_from_src_dry_distros;
+  }
+
+  // maximum number of SDs of a process, with the grid of the process and rlx_sd_per_bin (per process) set in opts_init;
+  // copies: space for SDs copied between devices or processes
+  static decltype(libcloudphxx::lgrngn::opts_init_t<real_t>::n_sd_max) calc_n_sd_max(
+    const libcloudphxx::lgrngn::opts_init_t<real_t> &opts_init,
+    const int n_sd_per_cell,
+    const bool copies
+  )
+  {
+    decltype(libcloudphxx::lgrngn::opts_init_t<real_t>::n_sd_max) n_sd_max;
+    if(parent_t::n_dims == 2) // 2D
+    {
+      if(opts_init.sd_conc)
+      {
+        if(opts_init.sd_conc_large_tail)
+          n_sd_max = 1.2 * opts_init.nx * opts_init.nz * n_sd_per_cell; // 1.2 to make space for large tail
+        else
+          n_sd_max = opts_init.nx * opts_init.nz * n_sd_per_cell;
+      }
+      else
+        n_sd_max = 1.2 * opts_init.nx * opts_init.nz * 1.e8 * opts_init.dx * opts_init.dz / opts_init.sd_const_multi; // NOTE: hardcoded N_a=100/cm^3 !!
+
+      if(copies)
+        n_sd_max *= 1.4; // more space for copied SDs
+    }
+    else // 3D
+    {
+      if(opts_init.sd_conc)
+      {
+        if(opts_init.sd_conc_large_tail)
+          n_sd_max = 1.2 * opts_init.nx * opts_init.ny * opts_init.nz * n_sd_per_cell; // 1.2 to make space for large tail
+        else
+          n_sd_max =       opts_init.nx * opts_init.ny * opts_init.nz * n_sd_per_cell; 
+      }
+      else
+        n_sd_max = 1.2 * opts_init.nx * opts_init.ny * opts_init.nz * 1.e8 * opts_init.dx * opts_init.dy * opts_init.dz / opts_init.sd_const_multi; // hardcoded N_a=100/cm^3 !!
+
+      if(copies)
+        n_sd_max *= 1.3; // more space for copied SDs
+    }
+
+    // space for SD created via relaxation, impossible to know exactly how many will be added, because it depends on washout of SD...
+    int n_sd_from_rlx_dry_distros = opts_init.rlx_sd_per_bin * opts_init.rlx_bins * opts_init.nz * 100; // room for 100 rounds of full relaxation... 
+    n_sd_max += n_sd_from_rlx_dry_distros;
+    return n_sd_max;
+  }
+
+  static void estimate(detail::estimate_t &est, const rt_params_t &p)
+  {
+    parent_t::estimate(est, p);
+    est.arrays(__FILE__, "rv_pre_cond, rv_post_cond, th_pre_cond, th_post_cond", n_tmp_cond);
+    est.arrays(__FILE__, "r_c", n_tmp_rc);
+
+    // grid of a process, as in hook_ante_loop
+    auto opts_init = p.cloudph_opts_init;
+    opts_init.nx = est.local_nx();
+    opts_init.dx = p.di;
+    if(parent_t::n_dims == 3)
+    {
+      opts_init.ny = est.n(1);
+      opts_init.dy = p.dj;
+    }
+    opts_init.nz = est.n(parent_t::n_dims - 1);
+    opts_init.dz = p.dz;
+    opts_init.rlx_sd_per_bin /= est.procs();
+    const auto n_sd_max = calc_n_sd_max(opts_init, calc_n_sd_per_cell(p), p.backend == libcloudphxx::lgrngn::multi_CUDA || est.procs() > 1);
+    est.mem.add(__FILE__, "super-droplets (estimate for n_sd_max = " + std::to_string(n_sd_max) + ")", (unsigned long long)(n_sd_max) * sd_bytes);
+    est.mem.add(__FILE__, "libcloudph++ output buffer (outbuf)",
+      (unsigned long long)(opts_init.nx) * std::max(1, opts_init.ny) * opts_init.nz * sizeof(real_t));
+
+    est.fields(3); // sd_conc, RH, precip_rate
+    if(p.cloudph_opts_init.ice_switch)
+      est.fields(5); // r_i, ice_mom0, ice_a_mom1, ice_c_mom1, precip_rate_ice_mass
+
+    // moments of the spectra
+    est.outfreq_spec = p.outfreq_spec;
+    for (auto &rng_moms : p.out_dry) est.spec_fields(rng_moms.second.size());
+    for (auto &rng_moms : p.out_wet) est.spec_fields(rng_moms.second.size());
+    if(p.cloudph_opts_init.ice_switch)
+      for (auto &rng_moms : p.out_ice) est.spec_fields(2 * rng_moms.second.size()); // ice_a and ice_c
   }
 
 };
@@ -1,5 +1,7 @@
 #pragma once
 #include "slvr_common.hpp"
+#include <algorithm>
+#include <cmath>
 #include "../detail/blitz_hlpr_fctrs.hpp"
 #include "../formulae/stress_formulae.hpp"
 
@@ -32,73 +34,128 @@ class slvr_sgs : public slvr_common<ct_params_t>
     &sgs_th_flux,   ///< SGS heat flux
     &sgs_rv_flux;   ///< SGS water vapor flux
 
+  setup::arr_1D_t sgs_exner, sgs_th_ref_inv, sgs_len_sq, sgs_diss_fctr, ///< Per-level coefficients of calc_sgs_visc()
+                  sgs_N2;                                                ///< Per-thread column buffer of calc_sgs_visc()
+
   arrvec_t<typename parent_t::arr_t>
   &tmp_grad,           ///< Temporary gradient storage
   &sgs_momenta_fluxes; ///< SGS momentum fluxes
 
   /**
-  * @brief Computes Richardson number.
-  */
-  void calc_rcdsn_num()
+   * @brief Per-level coefficients of calc_sgs_visc(), they depend only on the reference profiles.
+   */
+  void init_sgs_visc()
   {
-    using libmpdataxx::arakawa_c::h;
-
-    const auto g = (libcloudphxx::common::earth::g<setup::real_t>() / si::metres_per_second_squared);
-
-    const auto dz = params.dz;
-    const auto& tht = this->state(ix::th);
-    const auto& rv = this->state(ix::rv);
-    // depending on microphysics we either have rc already (blk_m1) or have to diagnose it (lgrngn)
-    const auto& rc = this->get_rc(rcdsn_num); // use rcdsn_num as temp storage for rc
-   
-    // libcloudph stuff
-    const auto l_tri = libcloudphxx::common::const_cp::l_tri<setup::real_t>() * si::kilograms / si::joules;
-    const auto eps = libcloudphxx::common::moist_air::eps<setup::real_t>();// / si::dimensionless;
-    const auto c_pd = libcloudphxx::common::moist_air::c_pd<setup::real_t>() * si::kilograms * si::kelvins / si::joules;
-    const auto R_d = libcloudphxx::common::moist_air::R_d<setup::real_t>() * si::kilograms  * si::kelvins/ si::joules;
     using libcloudphxx::common::theta_std::exner;
+    const int nz = this->vert_rng.length();
+    const real_t c_eps = 0.845; // TODO: c_eps should be an adjustable parameter for different cases
 
-    // some constant coefficients
-    const auto cf1 = (1 - eps) / eps;
-    const auto cf2 = l_tri / R_d;
-    const auto cf3 = l_tri / c_pd;
-    const auto cf4 = eps * cf2 * cf3;
+    for(auto *prof : {&sgs_exner, &sgs_th_ref_inv, &sgs_len_sq, &sgs_diss_fctr})
+      prof->resize(nz);
+    sgs_N2.resize(nz + 1);
 
-    // TODO: loops are bad, very bad !
-    for (int k = this->vert_rng.first(); k <= this->vert_rng.last() - 1; ++k)
+    for(int k = 0; k < nz; ++k)
     {
-      const auto th_ref_kph = 0.5 * ((*this->params.th_ref)(k + 1) + (*this->params.th_ref)(k));
-      const auto dthtdz_kph = (this->hrzntl_slice(tht, k + 1) - this->hrzntl_slice(tht, k)) / dz;
-      const auto rv_kph = 0.5 * (this->hrzntl_slice(rv, k + 1) + this->hrzntl_slice(rv, k));
-      const auto drvdz_kph = (this->hrzntl_slice(rv, k + 1) - this->hrzntl_slice(rv, k)) / dz;
-      
-      const auto N2unsat = g * (dthtdz_kph / th_ref_kph + cf1 / (1 + cf1 * rv_kph) * drvdz_kph);
-     
-      const auto T_kp1 = this->hrzntl_slice(tht, k + 1) * exner((*this->params.p_e)(k + 1) * si::pascals);
-      const auto T_k = this->hrzntl_slice(tht, k) * exner((*this->params.p_e)(k) * si::pascals);
-      const auto T_kph = 0.5 * (T_kp1 + T_k);
-      const auto drwdz_kph = ( this->hrzntl_slice(rv, k + 1) + this->hrzntl_slice(rc, k + 1) 
-                             - this->hrzntl_slice(rv, k) - this->hrzntl_slice(rc, k)         ) / dz;
-
-      const auto gamma = (1 + cf2 * rv_kph / T_kph) / (1 + cf4 * rv_kph / (T_kph * T_kph));
-      
-      const auto N2sat = g * (gamma * (dthtdz_kph / th_ref_kph + cf3 * drvdz_kph / T_kph) - drwdz_kph);
-      
-      const auto rc_kph = 0.5 * (this->hrzntl_slice(rc, k + 1) + this->hrzntl_slice(rc, k));
-
-      tmp_grad[ct_params_t::n_dims - 1](this->hrzntl_slice(k + h))
-      =
-      blitz::where(rc_kph > 1e-6, N2sat, N2unsat);
+      const real_t mix_len = (*params.mix_len)(k);
+      sgs_exner(k) = exner((*params.p_e)(k) * si::pascals);
+      sgs_th_ref_inv(k) = k < nz - 1 ? 2. / ((*params.th_ref)(k + 1) + (*params.th_ref)(k)) : 0; // at k+1/2
+      sgs_len_sq(k) = (this->smg_c * mix_len) * (this->smg_c * mix_len);
+      sgs_diss_fctr(k) = c_eps / ((this->c_m * mix_len) * (this->c_m * mix_len) * (this->c_m * mix_len)) / mix_len;
     }
+  }
 
-    // boundary conditions
-    tmp_grad[ct_params_t::n_dims - 1](this->hrzntl_slice(0 - h)) = tmp_grad[ct_params_t::n_dims - 1](this->hrzntl_slice(0 + h));
-    auto lk = this->vert_rng.last();
-    tmp_grad[ct_params_t::n_dims - 1](this->hrzntl_slice(lk + h)) = tmp_grad[ct_params_t::n_dims - 1](this->hrzntl_slice(lk - h));
-    
-    this->vert_aver_cmpct(tmp_grad[ct_params_t::n_dims - 1], rcdsn_num);
-    rcdsn_num(this->ijk) /= max(1e-15, tdef_sq(this->ijk)); // TODO: is 1e-15 sensible epsilon here ?
+  /**
+   * @brief Richardson number, stability correction, eddy viscosity and dissipation rate in one sweep.
+   *
+   * Done column by column (vertical is the contiguous dimension). In each column the squared
+   * Brunt-Vaisala frequency at k+1/2 is computed into a buffer, then rcdsn_num, k_m and diss_rate
+   * at all levels are computed from it. Loops over levels have no dependencies, so they are vectorized.
+   * Requires tdef_sq.
+   */
+  void calc_sgs_visc()
+  {
+    constexpr int n_dims = ct_params_t::n_dims;
+    const int nz = this->vert_rng.length();
+
+    const real_t g = libcloudphxx::common::earth::g<setup::real_t>() / si::metres_per_second_squared,
+                 eps = libcloudphxx::common::moist_air::eps<setup::real_t>(),
+                 l_tri = libcloudphxx::common::const_cp::l_tri<setup::real_t>() * si::kilograms / si::joules,
+                 c_pd = libcloudphxx::common::moist_air::c_pd<setup::real_t>() * si::kilograms * si::kelvins / si::joules,
+                 R_d = libcloudphxx::common::moist_air::R_d<setup::real_t>() * si::kilograms  * si::kelvins/ si::joules,
+                 cf1 = (1 - eps) / eps,
+                 cf2 = l_tri / R_d,
+                 cf3 = l_tri / c_pd,
+                 cf4 = eps * cf2 * cf3,
+                 dz_inv = 1. / params.dz,
+                 prandtl_inv = 1. / prandtl_num;
+
+    const auto &tht = this->state(ix::th);
+    const auto &rv = this->state(ix::rv);
+    // depending on microphysics we either have rc already (blk_m1) or have to diagnose it (lgrngn),
+    // in the latter case rc is stored in rcdsn_num; that is fine, because in each column rc is read before rcdsn_num is written
+    const auto &rc = this->get_rc(rcdsn_num);
+
+    const real_t *ex = sgs_exner.data(),
+                 *th_ref_inv = sgs_th_ref_inv.data(),
+                 *len_sq = sgs_len_sq.data(),
+                 *diss_fctr = sgs_diss_fctr.data();
+    real_t *N2 = sgs_N2.data(); // N2[k] at k-1/2
+
+    const auto s_th = tht.stride(n_dims - 1), s_rv = rv.stride(n_dims - 1), s_rc = rc.stride(n_dims - 1),
+               s_td = tdef_sq.stride(n_dims - 1), s_ri = rcdsn_num.stride(n_dims - 1),
+               s_km = this->k_m.stride(n_dims - 1), s_ds = this->diss_rate.stride(n_dims - 1);
+
+    // loop over columns of the subdomain
+    for(int c = 0; c < this->n_columns(); ++c)
+    {
+      const auto col = this->column(c);
+      const real_t *th_c = &tht(col),
+                   *rv_c = &rv(col),
+                   *rc_c = &rc(col),
+                   *td_c = &tdef_sq(col);
+      real_t *ri_c = &rcdsn_num(col),
+             *km_c = &this->k_m(col),
+             *ds_c = &this->diss_rate(col);
+
+      // squared Brunt-Vaisala frequency at k+1/2, saturated if there is cloud water
+      #pragma omp simd
+      for(int k = 0; k < nz - 1; ++k)
+      {
+        const real_t dthtdz = (th_c[(k + 1) * s_th] - th_c[k * s_th]) * dz_inv,
+                     drvdz  = (rv_c[(k + 1) * s_rv] - rv_c[k * s_rv]) * dz_inv,
+                     rv_kph = 0.5 * (rv_c[(k + 1) * s_rv] + rv_c[k * s_rv]),
+                     rc_kph = 0.5 * (rc_c[(k + 1) * s_rc] + rc_c[k * s_rc]),
+                     T_kph  = 0.5 * (th_c[(k + 1) * s_th] * ex[k + 1] + th_c[k * s_th] * ex[k]),
+                     drwdz  = (rv_c[(k + 1) * s_rv] + rc_c[(k + 1) * s_rc] - rv_c[k * s_rv] - rc_c[k * s_rc]) * dz_inv;
+
+        const real_t N2unsat = g * (dthtdz * th_ref_inv[k] + cf1 / (1 + cf1 * rv_kph) * drvdz);
+        const real_t gamma = (1 + cf2 * rv_kph / T_kph) / (1 + cf4 * rv_kph / (T_kph * T_kph));
+        const real_t N2sat = g * (gamma * (dthtdz * th_ref_inv[k] + cf3 * drvdz / T_kph) - drwdz);
+        N2[k + 1] = rc_kph > 1e-6 ? N2sat : N2unsat;
+      }
+      // boundary conditions
+      N2[0] = N2[1];
+      N2[nz] = N2[nz - 1];
+
+      // Richardson number at k and eddy viscosity with the stability correction
+      #pragma omp simd
+      for(int k = 0; k < nz; ++k)
+      {
+        const real_t td = td_c[k * s_td],
+                     ri = 0.5 * (N2[k] + N2[k + 1]) / std::max(real_t(1e-15), td), // TODO: is 1e-15 sensible epsilon here ?
+                     stab = 1 - ri * prandtl_inv;
+        ri_c[k * s_ri] = ri;
+        km_c[k * s_km] = stab > 0 ? len_sq[k] * std::sqrt(td * stab) : real_t(0);
+      }
+      km_c[0] = km_c[s_km];
+
+      // dissipation rate
+      #pragma omp simd
+      for(int k = 0; k < nz; ++k)
+        ds_c[k * s_ds] = diss_fctr[k] * km_c[k * s_km] * km_c[k * s_km] * km_c[k * s_km];
+    }
   }
+
   /**
  * @brief Computes SGS momentum fluxes in 2D.
  */
@@ -137,31 +194,23 @@ class slvr_sgs : public slvr_common<ct_params_t>
     static_assert(static_cast<libmpdataxx::solvers::stress_diff_t>(ct_params_t::stress_diff) == libmpdataxx::solvers::compact,
                   "UWLCM smagorinsky model requires compact stress differencing");
 
-    tdef_sq(this->ijk) = formulae::stress::calc_tdef_sq_cmpct<ct_params_t::n_dims>(this->tau, this->ijk);
-    calc_rcdsn_num();
-
-    this->k_m(this->ijk).reindex(this->zero) = where(
-                                 rcdsn_num(this->ijk).reindex(this->zero) / prandtl_num < 1,
-                                   pow2(this->smg_c * (*this->params.mix_len)(this->vert_idx))
-                                   * sqrt(tdef_sq(this->ijk).reindex(this->zero)
-                                   * (1 - rcdsn_num(this->ijk).reindex(this->zero) / prandtl_num)),
-                                   0
-                                );
-    this->k_m(this->hrzntl_slice(0)) = this->k_m(this->hrzntl_slice(1));
-    this->xchng_sclr(this->k_m, this->ijk, 1);
-    
-   
-    // calculate dissipation rate
+    detail::prof_scope_t prof_scope(this->params.prof, this->rank, detail::prof_sgs);
 
-    // TODO: c_eps should be an adjustable parameter for different cases
-    real_t c_eps = 0.845;
-    this->diss_rate(this->ijk).reindex(this->zero) = c_eps *
-      pow3(this->k_m(this->ijk).reindex(this->zero) / (this->c_m * (*this->params.mix_len)(this->vert_idx)))
-      / (*this->params.mix_len)(this->vert_idx);
+    tdef_sq(this->ijk) = formulae::stress::calc_tdef_sq_cmpct<ct_params_t::n_dims>(this->tau, this->ijk);
+    calc_sgs_visc(); // rcdsn_num, k_m and diss_rate
+    {
+      detail::prof_scope_t prof_scope(this->params.prof, this->rank, detail::prof_xchng);
+      ++this->n_xchng;
+      this->xchng_sclr(this->k_m, this->ijk, 1);
+    }
 
     formulae::stress::multiply_tnsr_cmpct<ct_params_t::n_dims, ct_params_t::opts>(this->tau, 1.0, this->k_m, *this->mem->G, this->ijkm_sep);
 
-    this->xchng_sgs_tnsr_offdiag(this->tau, this->tau_srfc, this->ijk, this->ijkm);
+    {
+      detail::prof_scope_t prof_scope(this->params.prof, this->rank, detail::prof_xchng);
+      ++this->n_xchng;
+      this->xchng_sgs_tnsr_offdiag(this->tau, this->tau_srfc, this->ijk, this->ijkm);
+    }
     
     //this->mem->barrier();
     //if (this->rank == 0)
@@ -243,14 +292,18 @@ class slvr_sgs : public slvr_common<ct_params_t>
     {
       auto& field = this->state(s);
 
-      this->xchng_pres(field, this->ijk);
+      {
+        detail::prof_scope_t prof_scope(this->params.prof, this->rank, detail::prof_xchng);
+        ++this->n_xchng;
+        this->xchng_pres(field, this->ijk);
+      }
 
       formulae::nabla::calc_grad_cmpct<parent_t::n_dims>(tmp_grad, field, this->ijk, this->ijkm, this->dijk);
       for(int d = 0; d < parent_t::n_dims; ++d)
         nancheck(tmp_grad[d](this->ijk), "tmp_grad in sgs_scalar_forces after calc_grad_cmpct");
 
       // document why
-      this->mem->barrier();
+      this->barrier_at("sgs_scalar_forces: gradient");
 
       // ijk_vec is used, because MPI requires that thread rank 0 calculates next vector to the left of the process' domain
       formulae::stress::multiply_vctr_cmpct<ct_params_t::n_dims, ct_params_t::opts>(tmp_grad,
@@ -261,17 +314,21 @@ class slvr_sgs : public slvr_common<ct_params_t>
       for(int d = 0; d < parent_t::n_dims; ++d)
         nancheck(tmp_grad[d](this->ijk), "tmp_grad in sgs_scalar_forces after multiply_vctr_cmpct");
 
-      if (s == ix::th)
-      {
-        this->xchng_sgs_vctr(tmp_grad, this->surf_flux_sens, this->ijk);
-      }
-      else if (s == ix::rv)
       {
-        this->xchng_sgs_vctr(tmp_grad , this->surf_flux_lat , this->ijk);
-      }
-      else
-      {
-        this->xchng_sgs_vctr(tmp_grad , this->surf_flux_zero, this->ijk);
+        detail::prof_scope_t prof_scope(this->params.prof, this->rank, detail::prof_xchng);
+        ++this->n_xchng;
+        if (s == ix::th)
+        {
+          this->xchng_sgs_vctr(tmp_grad, this->surf_flux_sens, this->ijk);
+        }
+        else if (s == ix::rv)
+        {
+          this->xchng_sgs_vctr(tmp_grad , this->surf_flux_lat , this->ijk);
+        }
+        else
+        {
+          this->xchng_sgs_vctr(tmp_grad , this->surf_flux_zero, this->ijk);
+        }
       }
 
       for(int d = 0; d < parent_t::n_dims; ++d)
@@ -288,8 +345,7 @@ class slvr_sgs : public slvr_common<ct_params_t>
                                       this->ijk,
                                       this->dijk
                                     );
-        this->tmp1(this->ijk).reindex(this->zero) /= calc_exner()((*params.p_e)(this->vert_idx));
-        this->rhs.at(s)(this->ijk) += this->tmp1(this->ijk); 
+        this->rhs.at(s)(this->ijk) += this->tmp1(this->ijk) * this->vert_prof_view(this->exner_inv);
       }
       else
       {
@@ -319,6 +375,8 @@ class slvr_sgs : public slvr_common<ct_params_t>
     // explicit application of subgrid forcings
     if(at == 0)
     {
+      detail::prof_scope_t prof_scope(this->params.prof, this->rank, detail::prof_sgs);
+
       if (this->timestep == 0 || ((this->timestep + 1) % static_cast<int>(this->outfreq) < this->outwindow)) // timstep is increased after ante_step, i.e after update_rhs(at=0)
         calc_sgs_diag_fields();
 
@@ -367,6 +425,7 @@ class slvr_sgs : public slvr_common<ct_params_t>
    */
   void hook_ante_loop(int nt) 
   {
+    init_sgs_visc();
     parent_t::hook_ante_loop(nt); 
 
     if(this->rank==0)
@@ -417,6 +476,15 @@ class slvr_sgs : public slvr_common<ct_params_t>
       throw std::runtime_error("UWLCM: in SGS simulation either cdrag or fricvelsq need to be positive, not both");
   }
 
+  // numbers of arrays allocated in alloc(), also counted by estimate()
+  static constexpr int n_tmp = 3,                         // rcdsn_num, tdef_sq, tke
+                       n_tmp_vctr = ct_params_t::n_dims,  // tmp_grad (alloc_tmp_vctr allocates one array per dimension)
+                       n_momenta_fluxes = 2,              // sgs_momenta_fluxes
+                       n_sclr_fluxes = 2;                 // sgs_th_flux, sgs_rv_flux
+
+  // SGS arrays of libmpdata++, approximate: the symmetric deformation tensor, the vector of its divergence, k_m and its temporary
+  static constexpr int n_mpdata_sgs = ct_params_t::n_dims * (ct_params_t::n_dims + 1) / 2 + ct_params_t::n_dims + 2;
+
   /**
  * @brief Allocates temporary storage required by SGS computations.
  *
@@ -426,9 +494,24 @@ class slvr_sgs : public slvr_common<ct_params_t>
   static void alloc(typename parent_t::mem_t *mem, const int &n_iters)
   {
     parent_t::alloc(mem, n_iters);
-    parent_t::alloc_tmp_sclr(mem, __FILE__, 3); // rcdsn_num, tdef_sq, tke
+    parent_t::alloc_tmp_sclr(mem, __FILE__, n_tmp); // rcdsn_num, tdef_sq, tke
+    detail::mem_ledger().add_tmp(mem, __FILE__, "rcdsn_num, tdef_sq, tke");
     parent_t::alloc_tmp_vctr(mem, __FILE__); // tmp_grad
-    parent_t::alloc_tmp_sclr(mem, __FILE__, 2); // sgs_momenta_fluxes
-    parent_t::alloc_tmp_sclr(mem, __FILE__, 2); // sgs_th/rv_flux
+    detail::mem_ledger().add_tmp(mem, __FILE__, "tmp_grad");
+    parent_t::alloc_tmp_sclr(mem, __FILE__, n_momenta_fluxes); // sgs_momenta_fluxes
+    detail::mem_ledger().add_tmp(mem, __FILE__, "sgs_momenta_fluxes");
+    parent_t::alloc_tmp_sclr(mem, __FILE__, n_sclr_fluxes); // sgs_th/rv_flux
+    detail::mem_ledger().add_tmp(mem, __FILE__, "sgs_th_flux, sgs_rv_flux");
+  }
+
+  static void estimate(detail::estimate_t &est, const rt_params_t &p)
+  {
+    parent_t::estimate(est, p);
+    est.arrays("libmpdata++", "SGS (approximate)", n_mpdata_sgs);
+    est.arrays(__FILE__, "rcdsn_num, tdef_sq, tke", n_tmp);
+    est.arrays(__FILE__, "tmp_grad", n_tmp_vctr);
+    est.arrays(__FILE__, "sgs_momenta_fluxes", n_momenta_fluxes);
+    est.arrays(__FILE__, "sgs_th_flux, sgs_rv_flux", n_sclr_fluxes);
+    est.fields(ct_params_t::n_dims > 2 ? 7 : 6); // k_m, tke, sgs_u/v_flux, p, sgs_th/rv_flux
   }
 };
@@ -78,6 +78,7 @@ int main(int argc, char** argv)
       ("spinup", po::value<int>()->default_value(0) , "number of initial timesteps during which rain formation is to be turned off")
       ("serial", po::value<bool>()->default_value(false), "force CPU component of the model (dynamics and bulk microphysics) to be computed on single thread")
       ("window", po::value<bool>()->default_value(false), "moving-window simulation, i.e. mean horizontal velocity substracted from advectors")
+      ("sounding", po::value<std::string>()->default_value(""), "file (text with a header line of column names, or HDF5 with one 1D dataset per column) with the initial sounding to be used instead of the compiled-in one, currently only in cumulus_congestus_icmw24 (columns: z [m], theta [K], rv [g/kg], u [m/s], v [m/s])")
 //      ("th_src", po::value<bool>()->default_value(true) , "temp src")
 //      ("rv_src", po::value<bool>()->default_value(true) , "water vap source")
 //      ("rc_src", po::value<bool>()->default_value(true) , "cloud water source (in blk_1/2m)")
@@ -91,6 +92,15 @@ int main(int argc, char** argv)
       ("sgs_delta", po::value<setup::real_t>()->default_value(-1) , "subgrid-scale turbulence model length scale [m]. If negative, sgs_delta = dz")
       ("help", "produce a help message (see also --micro X --help)")
       ("relax_th_rv", po::value<bool>()->default_value(false) , "relax per-level mean theta and rv to a desired (case-specific) profile")
+      ("reuse_buoyancy", po::value<bool>()->default_value(true) , "reuse buoyancy from the end of the previous timestep instead of recomputing it (done only if th is not modified in between, i.e. for dry buoyancy without microphysics; results are the same)")
+      ("prof", po::value<bool>()->default_value(false) , "time code regions and waits in barriers of each thread, without synchronization; the timings and the barrier imbalance report are written to outdir/profile.json at the end of the run (also if it is stopped)")
+      ("prof_counters", po::value<bool>()->default_value(false) , "with --prof, also collect hardware counters (cycles, instructions, cache references and misses) of the code regions using Linux perf_event_open; skipped if unavailable")
+      ("trace_from", po::value<int>()->default_value(-1) , "if >= 0, record a timeline of code regions and barriers of each thread, from this timestep (counted from 0) to trace_to, and write it to outdir/trace.json (Chrome trace format, for chrome://tracing or Perfetto)")
+      ("trace_to", po::value<int>()->default_value(-1) , "last traced timestep, see trace_from; by default the same as trace_from")
+      ("estimate", po::value<bool>()->default_value(false) , "instead of running the simulation, print the estimated memory per process and output volume of the run with the given options (run it as a single process)")
+      ("estimate_procs", po::value<int>()->default_value(1) , "number of MPI processes assumed in the estimate")
+      ("estimate_steps", po::value<int>()->default_value(0) , "with --estimate, also run this many timesteps of the same setup (output of the initial state only, to outdir/estimate), print the measured memory and extrapolate the wall time to nt timesteps")
+      ("status_interval", po::value<int>()->default_value(30) , "rewrite outdir/status.json with the progress of the run (timestep, steps per second, ETA, RSS, number of super-droplets and the last output) at most every this many seconds of wall time, 0 to turn it off")
 
       // aerosol distribution params
       // default values are realistic params, except n1_stp=n2_stp=-1
@@ -176,6 +186,17 @@ int main(int argc, char** argv)
 
 //    user_params.relax_ccn = vm["relax_ccn"].as<bool>();
     user_params.relax_th_rv = vm["relax_th_rv"].as<bool>();
+    user_params.reuse_buoyancy = vm["reuse_buoyancy"].as<bool>();
+    user_params.prof = vm["prof"].as<bool>();
+    user_params.prof_counters = vm["prof_counters"].as<bool>();
+    user_params.trace_from = vm["trace_from"].as<int>();
+    user_params.trace_to = vm["trace_to"].as<int>();
+    user_params.estimate = vm["estimate"].as<bool>();
+    user_params.estimate_procs = vm["estimate_procs"].as<int>();
+    user_params.estimate_steps = vm["estimate_steps"].as<int>();
+    if(user_params.estimate_steps < 0) throw std::runtime_error("UWLCM: estimate_steps cannot be negative");
+    user_params.status_interval = vm["status_interval"].as<int>();
+    if(user_params.status_interval < 0) throw std::runtime_error("UWLCM: status_interval cannot be negative");
 
     bool piggy = vm["piggy"].as<bool>();
     bool sgs = vm["sgs"].as<bool>();
@@ -216,6 +237,7 @@ int main(int argc, char** argv)
 
     // handling the "case" option
     user_params.model_case = vm["case"].as<std::string>();
+    user_params.sounding_file = vm["sounding"].as<std::string>();
 
     if(micro != "none" && user_params.model_case == "dry_thermal")
       throw std::runtime_error("UWLCM: The dry_thermal case needs micro set to 'none'");
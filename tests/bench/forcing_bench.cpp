@@ -0,0 +1,58 @@
+// benchmark of the rv/th forcings of the model (slvr_common::rv_src / th_src, which compute the terms set by the case
+// and add them up in sum_src, and sum_src alone, with the terms of th_src), called in a minimal solver context
+// (see solver_bench.hpp) of the given case with blk_1m microphysics, on the fields after the first timestep;
+// the number of threads is taken from OMP_NUM_THREADS, as in the model
+// case, grid sizes and the number of repetitions are given on the command line
+
+#include "solver_bench.hpp"
+
+template <class ct_params_t>
+class forcings_t : public bench_slvr_t<slvr_blk_1m<ct_params_t>>
+{
+  using parent_t = bench_slvr_t<slvr_blk_1m<ct_params_t>>;
+  using ix = typename ct_params_t::ix;
+
+  protected:
+
+  int n_routines() override { return 3; }
+
+  const char *routine_name(const int r) override
+  {
+    const char *names[] = {"rv_src", "th_src", "sum_src"};
+    return names[r];
+  }
+
+  void routine(const int r) override
+  {
+    switch(r)
+    {
+      case 0: this->rv_src(); break;
+      case 1: this->th_src(this->state(ix::rv)); break;
+      case 2: this->sum_src(this->rad_src, this->srfc_sens_src, this->srfc_sens_fctr, this->lvl_src); break;
+    }
+  }
+
+  public:
+
+  forcings_t(
+    typename parent_t::ctor_args_t args,
+    const typename parent_t::rt_params_t &p
+  ) :
+    parent_t(args, p)
+  {}
+};
+
+int main(int argc, char** argv)
+{
+  if (argc != 6) error_macro("expecting five arguments: case nx ny nz n_reps");
+  const std::string model_case = argv[1];
+  const int nx = std::stoi(argv[2]), ny = std::stoi(argv[3]), nz = std::stoi(argv[4]);
+  bench::n_reps = std::stoi(argv[5]);
+
+  // options of the model are not taken from the command line
+  ac = 1;
+  av = argv;
+
+  std::cout << model_case << ", blk_1m, ILES" << std::endl;
+  run_hlpr<forcings_t, ct_params_3D_blk_1m, 3>(false, false, model_case, {nx, ny, nz}, bench::user_params(model_case, "forcing_bench_out", 1));
+}
@@ -0,0 +1,81 @@
+// microbenchmarks of single routines of the model, called in a minimal solver context (see solver_bench.hpp) of the given case,
+// microphysics (blk_1m or blk_2m) and SGS model: buoyancy, radiation, subsidence (as set by the case), subsidence applied
+// in place (with zero timestep), surface sensible heat flux, horizontal means of the registered mean profiles,
+// the SGS eddy viscosity (with the SGS model only) and the whole update_rhs of the solver (forcings and microphysics);
+// the number of threads is taken from OMP_NUM_THREADS, as in the model
+// case, microphysics, SGS model (0 or 1), grid sizes and the number of repetitions are given on the command line
+
+#include "solver_bench.hpp"
+
+template <class solver_t>
+class kernels_t : public bench_slvr_t<solver_t>
+{
+  using parent_t = bench_slvr_t<solver_t>;
+  using ix = typename solver_t::ix;
+
+  // calc_sgs_visc exists only in solvers with the SGS model
+  void sgs_visc(smg_tag) { this->calc_sgs_visc(); }
+  void sgs_visc(iles_tag) {}
+
+  protected:
+
+  int n_routines() override { return 8; }
+
+  const char *routine_name(const int r) override
+  {
+    const char *names[] = {"buoyancy", "radiation", "subsidence", "subsidence_apply", "surf_sens", "calc_mean_profs", "calc_sgs_visc", "update_rhs"};
+    return names[r];
+  }
+
+  void routine(const int r) override
+  {
+    switch(r)
+    {
+      case 0: this->buoyancy(this->state(ix::th), this->state(ix::rv)); break;
+      case 1: if(this->params.radiation) this->radiation(this->state(ix::rv)); break;
+      case 2: this->subsidence(ix::th); break;
+      case 3: this->subsidence_apply({this->r_l}, 0); break;
+      case 4: this->surf_sens(); break;
+      case 5: this->calc_mean_profs(); break;
+      case 6: sgs_visc(typename solver_t::sgs_tag()); break;
+      case 7: this->update_rhs(this->rhs, this->dt, 0); break;
+    }
+  }
+
+  public:
+
+  kernels_t(
+    typename parent_t::ctor_args_t args,
+    const typename parent_t::rt_params_t &p
+  ) :
+    parent_t(args, p)
+  {}
+};
+
+template <class ct_params_t>
+using kernels_blk_1m_t = kernels_t<slvr_blk_1m<ct_params_t>>;
+
+template <class ct_params_t>
+using kernels_blk_2m_t = kernels_t<slvr_blk_2m<ct_params_t>>;
+
+int main(int argc, char** argv)
+{
+  if (argc != 8) error_macro("expecting seven arguments: case micro sgs nx ny nz n_reps");
+  const std::string model_case = argv[1], micro = argv[2];
+  const bool sgs = std::stoi(argv[3]);
+  const int nx = std::stoi(argv[4]), ny = std::stoi(argv[5]), nz = std::stoi(argv[6]);
+  bench::n_reps = std::stoi(argv[7]);
+
+  // options of the model are not taken from the command line
+  ac = 1;
+  av = argv;
+
+  const user_params_t user_params = bench::user_params(model_case, "kernel_bench_out", 1);
+  std::cout << model_case << ", " << micro << (sgs ? ", SGS" : ", ILES") << std::endl;
+  if (micro == "blk_1m")
+    run_hlpr<kernels_blk_1m_t, ct_params_3D_blk_1m, 3>(false, sgs, model_case, {nx, ny, nz}, user_params);
+  else if (micro == "blk_2m")
+    run_hlpr<kernels_blk_2m_t, ct_params_3D_blk_2m, 3>(false, sgs, model_case, {nx, ny, nz}, user_params);
+  else
+    error_macro("micro has to be blk_1m or blk_2m, got: " << micro)
+}
@@ -0,0 +1,119 @@
+// end-to-end benchmark of the model: short runs of DYCOMS, RICO and BOMEX in 2D and 3D with blk_1m, blk_2m and lgrngn micro,
+// with the profiler on (--prof); reports throughput (cell and super-droplet updates per second of the timestepping loop)
+// and the times of the hooks, and compares the throughput with a baseline file (written by a previous run)
+
+#include <cstdlib> // system()
+#include <vector>
+#include <string>
+#include <sstream> // std::ostringstream
+#include <fstream>
+#include <map>
+
+#include "../common.hpp"
+#include "profile.hpp"
+
+using std::ostringstream;
+using std::vector;
+using std::string;
+
+struct bench_size_t { string name; vector<int> nps_2d, nps_3d; int nt, sd_conc; };
+
+const vector<bench_size_t> sizes({
+  {"small",  {64, 61},   {16, 16, 61},   5,  16},
+  {"medium", {128, 121}, {32, 32, 121},  10, 32},
+  {"large",  {256, 301}, {64, 64, 301},  20, 64}
+});
+
+// name followed by cell and super-droplet updates per second
+std::map<string, vector<double>> read_results(const string &file)
+{
+  std::map<string, vector<double>> res;
+  std::ifstream in(file);
+  string name;
+  double cells, sds;
+  while (in >> name >> cells >> sds)
+    res[name] = {cells, sds};
+  return res;
+}
+
+int main(int ac, char** av)
+{
+  if (ac < 5 || ac > 7) error_macro("expecting four to six arguments: 1. CMAKE_BINARY_DIR 2. size (small, medium or large) 3. baseline file 4. regression threshold (e.g. 0.1 for 10% lower throughput) 5. backend of lgrngn (optional, default OpenMP) 6. additional command line options (optional)");
+  const string size_name = av[2], baseline = av[3], backend = ac > 5 ? av[5] : "OpenMP", opts_additional = ac > 6 ? av[6] : "";
+  const double threshold = std::stod(av[4]);
+
+  const bench_size_t *size = nullptr;
+  for (auto &s : sizes)
+    if (s.name == size_name) size = &s;
+  if (size == nullptr) error_macro("unknown size: " << size_name)
+
+  string opts_common =
+    "--outfreq=100000 --nt=" + std::to_string(size->nt) + " --prof=1 --rng_seed=44";
+  vector<string> cases({"dycoms_rf02", "rico11", "bomex03"});
+  vector<string> micros({"blk_1m", "blk_2m", "lgrngn"});
+
+  system("mkdir bench");
+
+  std::map<string, vector<double>> results;
+  for (auto &nps : {size->nps_2d, size->nps_3d})
+    for (auto &cs : cases)
+      for (auto &micro : micros)
+      {
+        const bool lgrngn = micro == "lgrngn";
+        const string name = cs + "_" + micro + "_" + std::to_string(nps.size()) + "D";
+        ostringstream opts;
+        opts << opts_common << " --case=" << cs << " --micro=" << micro
+             << " --nx=" << nps[0] << (nps.size() == 3 ? " --ny=" + std::to_string(nps[1]) : "") << " --nz=" << nps.back();
+        if (lgrngn) opts << " --async=false --backend=" << backend << " --sd_conc=" << size->sd_conc;
+        opts << " " << opts_additional;
+
+        ostringstream cmd;
+        cmd << av[1] <<  "/../../build/uwlcm " << opts.str() << " --outdir=\"bench/" << name << "\"";
+        cerr << endl << "=========" << endl;
+        notice_macro("about to call: " << cmd.str())
+        if (EXIT_SUCCESS != system(cmd.str().c_str()))
+          error_macro("model run failed: " << cmd.str())
+
+        const auto prof = read_profile("bench/" + name + "/profile.json");
+        double tloop = 0;
+        for (auto &r : prof) tloop += r.second;
+
+        double cells = size->nt;
+        for (auto n : nps) cells *= n;
+        results[name] = {cells / tloop, lgrngn ? cells * size->sd_conc / tloop : 0};
+
+        std::cout << name << ": loop " << tloop << " s, " << results[name][0] << " cell updates/s";
+        if (lgrngn) std::cout << ", " << results[name][1] << " super-droplet updates/s (initial number)";
+        std::cout << std::endl;
+        for (auto &r : prof)
+          std::cout << "  " << r.first << ": " << r.second << " s (" << r.second / tloop * 100 << "%)" << std::endl;
+      }
+
+  // stored for use as a baseline
+  {
+    std::ofstream out("bench/results_" + size_name + ".txt");
+    for (auto &r : results)
+      out << r.first << " " << r.second[0] << " " << r.second[1] << std::endl;
+  }
+
+  const auto base = read_results(baseline);
+  if (base.empty())
+  {
+    notice_macro("no baseline in " << baseline << ", to use these results as one: cp bench/results_" << size_name << ".txt " << baseline)
+    return EXIT_SUCCESS;
+  }
+
+  int n_regressions = 0;
+  std::cout << std::endl << "throughput relative to the baseline (" << baseline << "):" << std::endl;
+  for (auto &r : results)
+  {
+    auto b = base.find(r.first);
+    if (b == base.end()) continue;
+    const double ratio = r.second[0] / b->second[0];
+    const bool regression = ratio < 1 - threshold;
+    n_regressions += regression;
+    std::cout << "  " << r.first << ": " << ratio << (regression ? " REGRESSION" : "") << std::endl;
+  }
+  if (n_regressions > 0)
+    error_macro(n_regressions << " configurations slower than the baseline by more than " << threshold * 100 << "%")
+}
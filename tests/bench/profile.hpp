@@ -0,0 +1,29 @@
+#pragma once
+
+#include <fstream>
+#include <map>
+#include <string>
+
+#include "../common.hpp"
+
+// mean (over threads) times of the top-level regions of the timestepping loop from profile.json of a run with --prof [s]
+std::map<string, double> read_profile(const string &file)
+{
+  std::ifstream in(file);
+  if (!in.good()) error_macro("profiler output not found: " << file)
+  std::map<string, double> res;
+  string line;
+  while (std::getline(in, line))
+  {
+    const string key = "{\"path\": \"";
+    const auto beg = line.find(key);
+    if (beg == string::npos) continue;
+    const auto end = line.find('"', beg + key.size());
+    const string path = line.substr(beg + key.size(), end - beg - key.size());
+    if (path.find('/') != string::npos || path == "hook_ante_loop") continue; // nested or before the loop
+    const auto mean = line.find("\"mean\": ");
+    if (mean == string::npos) continue;
+    res[path] = std::stod(line.substr(mean + 8));
+  }
+  return res;
+}
@@ -0,0 +1,159 @@
+// strong and weak scaling of a case/micro configuration on one machine: runs with 1 (--serial), 2, 4, ... OpenMP threads
+// and with 2, 4, ... MPI processes of one thread each, with the profiler on (--prof); reports speedup and efficiency
+// of the timestepping loop and of each top-level hook, and flags hooks with efficiency below the threshold;
+// in weak scaling, the grid of one worker (thread or process) grows with the number of workers in x (weak_x),
+// as the domain is divided among workers in x, or alternately in x and y (weak_xy, in 2D as weak_x)
+
+#include <cstdlib> // system()
+#include <vector>
+#include <string>
+#include <sstream> // std::ostringstream
+#include <fstream>
+#include <map>
+
+#include "../common.hpp"
+#include "profile.hpp"
+
+using std::ostringstream;
+using std::vector;
+using std::string;
+
+struct config_t
+{
+  int ranks, threads;
+  vector<int> nps;
+  double tloop;
+  std::map<string, double> hooks;
+
+  int workers() const { return ranks * threads; }
+};
+
+vector<int> parse_grid(const string &grid)
+{
+  vector<int> res;
+  std::istringstream in(grid);
+  string n;
+  while (std::getline(in, n, 'x'))
+    res.push_back(std::stoi(n));
+  if (res.size() != 2 && res.size() != 3) error_macro("grid has to be given as nxXnz or nxXnyXnz, got: " << grid)
+  return res;
+}
+
+// grid of a weak scaling run with p workers (p is a power of 2)
+vector<int> weak_grid(vector<int> nps, const string &mode, const int p)
+{
+  int d = 0;
+  for (int f = p; f > 1; f /= 2)
+  {
+    nps[d] *= 2;
+    if (mode == "weak_xy" && nps.size() == 3) d = 1 - d;
+  }
+  return nps;
+}
+
+// relative to the run with one worker (time t1), p workers took tp; in weak scaling the speedup is the scaled one (efficiency times workers)
+double efficiency(const bool strong, const double t1, const double tp, const int p)
+{
+  return tp > 0 ? (strong ? t1 / (p * tp) : t1 / tp) : 0;
+}
+
+string grid_str(const vector<int> &nps)
+{
+  ostringstream res;
+  for (std::size_t d = 0; d < nps.size(); ++d) res << (d == 0 ? "" : "x") << nps[d];
+  return res.str();
+}
+
+int main(int ac, char** av)
+{
+  if (ac < 9 || ac > 12) error_macro("expecting eight to eleven arguments: 1. CMAKE_BINARY_DIR 2. case 3. micro 4. mode (strong, weak_x or weak_xy) 5. grid (e.g. 128x121 or 64x64x121, of one worker in weak scaling) 6. nt 7. maximum number of threads 8. maximum number of MPI processes (1 for no MPI runs) 9. efficiency threshold (optional, default 0.5) 10. MPI launcher (optional, default mpirun) 11. additional command line options (optional)");
+  const string cs = av[2], micro = av[3], mode = av[4];
+  const vector<int> nps0 = parse_grid(av[5]);
+  const int nt = std::stoi(av[6]), max_threads = std::stoi(av[7]), max_ranks = std::stoi(av[8]);
+  const double threshold = ac > 9 ? std::stod(av[9]) : 0.5;
+  const string mpirun = ac > 10 ? av[10] : "mpirun", opts_additional = ac > 11 ? av[11] : "";
+  if (mode != "strong" && mode != "weak_x" && mode != "weak_xy") error_macro("unknown mode: " << mode)
+  const bool strong = mode == "strong";
+
+  // threads in one process, then processes of one thread
+  vector<config_t> configs;
+  for (int t = 1; t <= max_threads; t *= 2) configs.push_back(config_t{1, t, {}, 0, {}});
+  for (int r = 2; r <= max_ranks; r *= 2) configs.push_back(config_t{r, 1, {}, 0, {}});
+
+  const string name = cs + "_" + micro + "_" + mode + "_" + grid_str(nps0);
+  system("mkdir scaling");
+
+  for (auto &c : configs)
+  {
+    c.nps = strong ? nps0 : weak_grid(nps0, mode, c.workers());
+    if (c.nps[0] < c.workers()) error_macro("nx = " << c.nps[0] << " is smaller than the number of workers: " << c.workers())
+
+    const string outdir = "scaling/" + name + "/r" + std::to_string(c.ranks) + "_t" + std::to_string(c.threads);
+    ostringstream cmd;
+    if (c.ranks > 1) cmd << mpirun << " -np " << c.ranks << " ";
+    else if (c.threads > 1) cmd << "OMP_NUM_THREADS=" << c.threads << " ";
+    cmd << av[1] << "/../../build/uwlcm --outfreq=100000 --nt=" << nt << " --prof=1 --rng_seed=44"
+        << " --case=" << cs << " --micro=" << micro
+        << " --nx=" << c.nps[0] << (c.nps.size() == 3 ? " --ny=" + std::to_string(c.nps[1]) : "") << " --nz=" << c.nps.back()
+        << (c.threads == 1 ? " --serial=1" : "")
+        << " " << opts_additional << " --outdir=\"" << outdir << "\"";
+    cerr << endl << "=========" << endl;
+    notice_macro("about to call: " << cmd.str())
+    if (EXIT_SUCCESS != system(cmd.str().c_str()))
+      error_macro("model run failed: " << cmd.str())
+
+    c.hooks = read_profile(outdir + "/profile.json");
+    c.tloop = 0;
+    for (auto &h : c.hooks) c.tloop += h.second;
+  }
+
+  const config_t &ref = configs.front();
+
+  ostringstream out;
+  out << name << ", " << nt << " timesteps" << std::endl << std::endl
+      << std::setw(6) << "procs" << std::setw(8) << "threads" << std::setw(16) << "grid"
+      << std::setw(14) << "loop [s]" << std::setw(10) << "speedup" << std::setw(12) << "efficiency" << std::endl;
+  for (auto &c : configs)
+  {
+    const double eff = efficiency(strong, ref.tloop, c.tloop, c.workers());
+    out << std::setw(6) << c.ranks << std::setw(8) << c.threads << std::setw(16) << grid_str(c.nps)
+        << std::setw(14) << c.tloop << std::setw(10) << eff * c.workers() << std::setw(12) << eff << std::endl;
+  }
+
+  // efficiency of hooks, * marks the ones below the threshold
+  std::map<string, string> flagged; // hook and the first configuration in which it is below the threshold
+  out << std::endl << "efficiency of hooks (* below " << threshold << "):" << std::endl << std::setw(28) << "";
+  for (auto &c : configs)
+    out << std::setw(10) << ("r" + std::to_string(c.ranks) + "t" + std::to_string(c.threads));
+  out << std::endl;
+  for (auto &h : ref.hooks)
+  {
+    out << std::setw(28) << h.first;
+    for (auto &c : configs)
+    {
+      const auto it = c.hooks.find(h.first);
+      const double eff = efficiency(strong, h.second, it == c.hooks.end() ? 0 : it->second, c.workers());
+      const bool below = eff < threshold;
+      if (below && flagged.count(h.first) == 0)
+        flagged[h.first] = std::to_string(c.ranks) + " processes, " + std::to_string(c.threads) + " threads";
+      ostringstream cell;
+      cell << std::setprecision(3) << eff << (below ? "*" : "");
+      out << std::setw(10) << cell.str();
+    }
+    out << std::endl;
+  }
+
+  out << std::endl;
+  if (flagged.empty())
+    out << "all hooks scale with efficiency above " << threshold << std::endl;
+  else
+  {
+    out << "hooks that stop scaling (efficiency below " << threshold << " from):" << std::endl;
+    for (auto &f : flagged)
+      out << "  " << f.first << ": " << f.second << std::endl;
+  }
+
+  std::cout << std::endl << out.str();
+  std::ofstream file("scaling/" + name + ".txt");
+  file << out.str();
+}
@@ -0,0 +1,43 @@
+// benchmark of the Smagorinsky eddy viscosity of the model (slvr_sgs::calc_sgs_visc: Richardson number, eddy viscosity
+// and dissipation rate computed column by column), called in a minimal solver context (see solver_bench.hpp) of the given case
+// with blk_1m microphysics and the SGS model, on the deformation computed in the first timestep;
+// the number of threads is taken from OMP_NUM_THREADS, as in the model
+// case, grid sizes and the number of repetitions are given on the command line
+
+#include "solver_bench.hpp"
+
+template <class ct_params_t>
+class sgs_visc_t : public bench_slvr_t<slvr_blk_1m<ct_params_t>>
+{
+  using parent_t = bench_slvr_t<slvr_blk_1m<ct_params_t>>;
+
+  protected:
+
+  int n_routines() override { return 1; }
+  const char *routine_name(const int) override { return "calc_sgs_visc"; }
+  void routine(const int) override { this->calc_sgs_visc(); }
+
+  public:
+
+  sgs_visc_t(
+    typename parent_t::ctor_args_t args,
+    const typename parent_t::rt_params_t &p
+  ) :
+    parent_t(args, p)
+  {}
+};
+
+int main(int argc, char** argv)
+{
+  if (argc != 6) error_macro("expecting five arguments: case nx ny nz n_reps");
+  const std::string model_case = argv[1];
+  const int nx = std::stoi(argv[2]), ny = std::stoi(argv[3]), nz = std::stoi(argv[4]);
+  bench::n_reps = std::stoi(argv[5]);
+
+  // options of the model are not taken from the command line
+  ac = 1;
+  av = argv;
+
+  std::cout << model_case << ", blk_1m, SGS" << std::endl;
+  run_hlpr<sgs_visc_t, ct_params_3D_blk_1m, 3>(false, true, model_case, {nx, ny, nz}, bench::user_params(model_case, "sgs_bench_out", 1));
+}
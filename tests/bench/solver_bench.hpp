@@ -0,0 +1,107 @@
+#pragma once
+
+// minimal solver context of the microbenchmarks of model routines: a model run (run_hlpr() of src/run_hlpr.cpp) of one
+// timestep of a case on a 3D grid, after which the routines are called by all threads of the solver on the fields of the model;
+// the solver of the run is bench_slvr_t<solver>, from which the benchmarks derive to call the (protected) routines;
+// the number of threads is set with OMP_NUM_THREADS, as in the model; the model adds options to a global list
+// in setopts_micro, so there is one run per process
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+
+#include "../../src/run_hlpr.cpp"
+#include "../common.hpp"
+
+namespace bench
+{
+  int n_reps; // calls of each routine, set in main()
+
+  // user_params of a run of nt timesteps of the case, with the defaults of uwlcm.cpp and no output apart from the initial one
+  user_params_t user_params(const std::string &model_case, const std::string &outdir, const int nt)
+  {
+    user_params_t res;
+    res.model_case = model_case;
+    res.outdir = outdir;
+    res.nt = nt;
+    res.outfreq = nt + 1;
+    res.outstart = 0;
+    res.outwindow = 1;
+    res.spinup = 0;
+    res.rng_seed = res.rng_seed_init = 44;
+    res.dt = 1;
+    res.X = res.Y = res.Z = -1; // case defaults
+    res.window = false;
+    res.sounding_file = "";
+    res.relax_th_rv = false;
+    res.reuse_buoyancy = true;
+    res.prof = false;
+    res.prof_counters = false;
+    res.trace_from = res.trace_to = -1;
+    res.estimate = false;
+    res.estimate_procs = 1;
+    res.estimate_steps = 0;
+    res.status_interval = 0;
+    res.sgs_delta = -1;
+    res.mean_rd1 = res.mean_rd2 = 1e-6 * si::metres;
+    res.sdev_rd1 = res.sdev_rd2 = 1.2;
+    res.n1_stp = res.n2_stp = -1. / si::cubic_metres; // case defaults
+    res.kappa1 = res.kappa2 = 0.61;
+    res.soluble_fraction1 = res.soluble_fraction2 = 1;
+    res.case_n_stp_multiplier = 1;
+    return res;
+  }
+};
+
+template <class solver_t>
+class bench_slvr_t : public solver_t
+{
+  using parent_t = solver_t;
+  using clock = std::chrono::steady_clock;
+
+  protected:
+
+  // routines of the benchmark, called by all threads
+  virtual int n_routines() = 0;
+  virtual const char *routine_name(const int r) = 0;
+  virtual void routine(const int r) = 0;
+
+  // at the end of the first timestep: one call to warm up and n_reps timed calls of each routine,
+  // from the barrier before the first call to the barrier after the last one, i.e. including load imbalance
+  void hook_post_step() override
+  {
+    parent_t::hook_post_step();
+    if(this->timestep != 1) return;
+
+    const bool print = this->rank == 0 && this->mem->distmem.rank() == 0;
+    const double n_cell = double(this->mem->distmem.grid_size[0]) * this->mem->distmem.grid_size[1] * this->mem->distmem.grid_size[2];
+    if(print)
+      std::cout << std::endl << "grid " << this->mem->distmem.grid_size[0] << "x" << this->mem->distmem.grid_size[1] << "x" << this->mem->distmem.grid_size[2]
+                << ", " << this->mem->size << " threads, " << bench::n_reps << " repetitions" << std::endl;
+
+    for(int r = 0; r < n_routines(); ++r)
+    {
+      routine(r);
+      this->mem->barrier();
+      const clock::time_point tbeg = clock::now();
+      for(int i = 0; i < bench::n_reps; ++i)
+        routine(r);
+      this->mem->barrier();
+      const double t = std::chrono::duration<double>(clock::now() - tbeg).count() / bench::n_reps;
+      if(print)
+        std::cout << "  " << std::left << std::setw(20) << routine_name(r) << std::right
+                  << std::setw(10) << t * 1e3 << " ms per call, "
+                  << std::setw(8) << t / n_cell * 1e9 << " ns per cell" << std::endl;
+    }
+  }
+
+  public:
+
+  bench_slvr_t(
+    typename parent_t::ctor_args_t args,
+    const typename parent_t::rt_params_t &p
+  ) :
+    parent_t(args, p)
+  {}
+};
@@ -0,0 +1,74 @@
+// checks bulk microphysics on grids of many columns, run on one and on several threads:
+// the initial saturation adjustment of blk_1m (cellwise, uses the environmental pressure) has to give identical results,
+// results after a few timesteps have to agree within round-off of the (threaded) pressure solver
+
+#include <cstdlib> // system()
+#include <vector>
+#include <string>
+#include <sstream> // std::ostringstream
+
+#include "../common.hpp"
+
+using std::ostringstream;
+using std::vector;
+using std::string;
+
+int main(int ac, char** av)
+{
+  if (ac != 2 && ac != 3) error_macro("expecting one or two arguments: 1. CMAKE_BINARY_DIR 2. additional command line options (optional)");
+  string opts_additional = ac == 3 ? av[2] : "";
+
+  const int nt = 2;
+  string opts_common =
+    "--outfreq=1 --nt=" + std::to_string(nt) + " --dt=1 --prs_tol=1e-6 --case=dycoms_rf02 --rng_seed=44";
+  vector<string> opts_dim({
+    "--nx=16 --nz=16",
+    "--nx=8 --ny=8 --nz=16"
+  });
+  vector<string> opts_micro({
+    "--micro=blk_1m",
+    "--micro=blk_2m"
+  });
+  // variables compared after the timesteps and the allowed absolute differences
+  vector<std::pair<string, string>> vars({
+    {"th", "1e-3"},
+    {"rv", "1e-6"},
+    {"rc", "1e-6"},
+    {"rr", "1e-7"}
+  });
+
+  system("mkdir blk");
+
+  for (auto &opts_d : opts_dim)
+    for (auto &opts_m : opts_micro)
+    {
+      ostringstream opts;
+      opts << opts_common << " " << opts_d << " " << opts_m << " " << opts_additional;
+      auto outdir = std::hash<std::string>{}(opts.str());
+
+      for (int threads : {1, 4})
+      {
+        ostringstream cmd;
+        cmd << "OMP_NUM_THREADS=" << threads << " " << av[1] << "/../../build/uwlcm " << opts.str() << " --outdir=\"blk/" << outdir << "_" << threads << "\"";
+
+        cerr << endl << "=========" << endl;
+        notice_macro("about to call: " << cmd.str())
+
+        if (EXIT_SUCCESS != system(cmd.str().c_str()))
+          error_macro("model run failed: " << cmd.str())
+      }
+
+      for (int t : {0, nt})
+        for (auto &v : vars)
+        {
+          ostringstream cmd;
+          string file = "timestep" + zeropad(t, 10) + ".h5";
+          cmd << "h5diff -v1 " << (t == 0 ? "" : "--delta=" + v.second + " ")
+              << "\"blk/" << outdir << "_1/" << file << "\" \"blk/" << outdir << "_4/" << file << "\" " << v.first;
+          notice_macro("about to call: " << cmd.str())
+
+          if (EXIT_SUCCESS != system(cmd.str().c_str()))
+            error_macro("results on one and on four threads differ: " << v.first << " at timestep " << t << ", " << opts.str())
+        }
+    }
+}
@@ -0,0 +1,66 @@
+// checks that reusing buoyancy from the end of the previous timestep (--reuse_buoyancy=1)
+// gives exactly the same results as computing it twice per timestep (--reuse_buoyancy=0)
+
+#include <cstdlib> // system()
+#include <vector>
+#include <string>
+#include <sstream> // std::ostringstream
+
+#include "../common.hpp"
+
+using std::ostringstream;
+using std::vector;
+using std::string;
+
+int main(int ac, char** av)
+{
+  if (ac != 2 && ac != 3) error_macro("expecting one or two arguments: 1. CMAKE_BINARY_DIR 2. additional command line options (optional)");
+  string opts_additional = ac == 3 ? av[2] : "";
+
+  const int nt = 5;
+  string opts_common =
+    "--outfreq=1 --nt=" + std::to_string(nt) + " --dt=1 --serial=true --prs_tol=1e-3 --micro=none --rng_seed=44";
+  vector<string> opts_dim({
+    "--nx=8 --nz=8",
+    "--nx=8 --ny=8 --nz=8"
+  });
+  // reuse is done only for dry buoyancy without microphysics
+  vector<string> opts_case({
+    "--case=dry_thermal",
+    "--case=dry_pbl"
+  });
+
+  system("mkdir buoyancy_reuse");
+
+  for (auto &opts_d : opts_dim)
+    for (auto &opts_c : opts_case)
+    {
+      ostringstream opts;
+      opts << opts_common << " " << opts_d << " " << opts_c << " " << opts_additional;
+      auto outdir = std::hash<std::string>{}(opts.str());
+
+      for (int reuse = 0; reuse < 2; ++reuse)
+      {
+        ostringstream cmd;
+        cmd << av[1] <<  "/../../build/uwlcm " << opts.str() << " --reuse_buoyancy=" << reuse << " --outdir=\"buoyancy_reuse/" << outdir << "_" << reuse << "\"";
+
+        cerr << endl << "=========" << endl;
+        notice_macro("about to call: " << cmd.str())
+
+        if (EXIT_SUCCESS != system(cmd.str().c_str()))
+          error_macro("model run failed: " << cmd.str())
+      }
+
+      // const.h5 differs in the recorded value of reuse_buoyancy, timesteps have to be identical
+      for (int t = 0; t <= nt; ++t)
+      {
+        ostringstream cmd;
+        string file = "timestep" + zeropad(t, 10) + ".h5";
+        cmd << "h5diff -v1 \"buoyancy_reuse/" << outdir << "_0/" << file << "\" \"buoyancy_reuse/" << outdir << "_1/" << file << "\"";
+        notice_macro("about to call: " << cmd.str())
+
+        if (EXIT_SUCCESS != system(cmd.str().c_str()))
+          error_macro("results with and without reuse of buoyancy differ: " << opts.str())
+      }
+    }
+}
@@ -0,0 +1,76 @@
+// checks that the initial state (with random perturbations) does not depend on the domain decomposition:
+// th and rv in timestep 0 of runs on one thread (--serial), on several threads and on several MPI processes have to be identical
+
+#include <cstdlib> // system()
+#include <vector>
+#include <string>
+#include <sstream> // std::ostringstream
+
+#include "../common.hpp"
+
+using std::ostringstream;
+using std::vector;
+using std::string;
+
+int main(int ac, char** av)
+{
+  if (ac != 3 && ac != 4) error_macro("expecting two or three arguments: 1. CMAKE_BINARY_DIR 2. MPI launcher (e.g. \"mpirun -np 2\", empty if UWLCM is not built with MPI) 3. additional command line options (optional)");
+  const string mpirun = av[2], opts_additional = ac == 4 ? av[3] : "";
+
+  string opts_common =
+    "--outfreq=1000 --nt=1 --dt=1 --prs_tol=1e-3 --micro=none --rng_seed=44";
+  vector<string> opts_dim({
+    "--nx=16 --nz=16",
+    "--nx=8 --ny=8 --nz=16"
+  });
+  // cases with random perturbations of the initial state
+  vector<string> opts_case({
+    "--case=dry_pbl",
+    "--case=dycoms_rf02",
+    "--case=rico11",
+    "--case=bomex03",
+    "--case=cumulus_congestus_icmw20"
+  });
+  // launchers and names of the runs, the first one is the reference
+  vector<std::pair<string, string>> runs({
+    {"", "serial"},
+    {"OMP_NUM_THREADS=4 ", "threads"}
+  });
+  if (!mpirun.empty())
+    runs.push_back({mpirun + " ", "mpi"});
+
+  system("mkdir decomposition");
+
+  for (auto &opts_d : opts_dim)
+    for (auto &opts_c : opts_case)
+    {
+      ostringstream opts;
+      opts << opts_common << " " << opts_d << " " << opts_c << " " << opts_additional;
+      auto outdir = std::hash<std::string>{}(opts.str());
+
+      for (auto &run : runs)
+      {
+        ostringstream cmd;
+        cmd << run.first << av[1] <<  "/../../build/uwlcm " << opts.str()
+            << (run.second == "threads" ? "" : " --serial=1") << " --outdir=\"decomposition/" << outdir << "_" << run.second << "\"";
+
+        cerr << endl << "=========" << endl;
+        notice_macro("about to call: " << cmd.str())
+
+        if (EXIT_SUCCESS != system(cmd.str().c_str()))
+          error_macro("model run failed: " << cmd.str())
+      }
+
+      const string file = "timestep" + zeropad(0, 10) + ".h5";
+      for (std::size_t r = 1; r < runs.size(); ++r)
+        for (const string var : {"th", "rv"})
+        {
+          ostringstream cmd;
+          cmd << "h5diff -v1 \"decomposition/" << outdir << "_serial/" << file << "\" \"decomposition/" << outdir << "_" << runs[r].second << "/" << file << "\" " << var;
+          notice_macro("about to call: " << cmd.str())
+
+          if (EXIT_SUCCESS != system(cmd.str().c_str()))
+            error_macro("initial " << var << " differs between the serial and the " << runs[r].second << " run: " << opts.str())
+        }
+    }
+}
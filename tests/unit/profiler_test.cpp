@@ -0,0 +1,101 @@
+// checks that the profiler (--prof=1) writes its output and does not change the results,
+// and that the profile of a run stopped with a signal is written and marked as not completed
+
+#include <cstdlib> // system()
+#include <vector>
+#include <string>
+#include <sstream> // std::ostringstream
+#include <fstream>
+
+#include "../common.hpp"
+
+using std::ostringstream;
+using std::vector;
+using std::string;
+
+int main(int ac, char** av)
+{
+  if (ac != 2 && ac != 3) error_macro("expecting one or two arguments: 1. CMAKE_BINARY_DIR 2. additional command line options (optional)");
+  string opts_additional = ac == 3 ? av[2] : "";
+
+  const int nt = 3;
+  string opts_common =
+    "--outfreq=1 --nt=" + std::to_string(nt) + " --dt=1 --serial=true --prs_tol=1e-3 --rng_seed=44";
+  vector<string> opts_dim({
+    "--nx=8 --nz=8",
+    "--nx=8 --ny=8 --nz=8"
+  });
+  vector<string> opts_micro({
+    "--case=dry_thermal --micro=none",
+    "--case=moist_thermal --micro=blk_1m"
+  });
+
+  system("mkdir profiler");
+
+  for (auto &opts_d : opts_dim)
+    for (auto &opts_m : opts_micro)
+    {
+      ostringstream opts;
+      opts << opts_common << " " << opts_d << " " << opts_m << " " << opts_additional;
+      auto outdir = std::hash<std::string>{}(opts.str());
+
+      for (int prof = 0; prof < 2; ++prof)
+      {
+        ostringstream cmd;
+        cmd << av[1] <<  "/../../build/uwlcm " << opts.str() << " --prof=" << prof << " --outdir=\"profiler/" << outdir << "_" << prof << "\"";
+
+        cerr << endl << "=========" << endl;
+        notice_macro("about to call: " << cmd.str())
+
+        if (EXIT_SUCCESS != system(cmd.str().c_str()))
+          error_macro("model run failed: " << cmd.str())
+      }
+
+      // profile of a completed run, with timings of hooks
+      std::ifstream in("profiler/" + std::to_string(outdir) + "_1/profile.json");
+      if (!in.good())
+        error_macro("profiler output not found: " << opts.str())
+      const string prof((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+      for (const string &s : {"\"completed\": true", "\"path\": \"hook_ante_step\"", "\"path\": \"hook_post_step\""})
+        if (prof.find(s) == string::npos)
+          error_macro("missing " << s << " in profiler output: " << opts.str())
+
+      for (int t = 0; t <= nt; ++t)
+      {
+        ostringstream cmd;
+        string file = "timestep" + zeropad(t, 10) + ".h5";
+        cmd << "h5diff -v1 \"profiler/" << outdir << "_0/" << file << "\" \"profiler/" << outdir << "_1/" << file << "\"";
+        notice_macro("about to call: " << cmd.str())
+
+        if (EXIT_SUCCESS != system(cmd.str().c_str()))
+          error_macro("results with and without profiling differ: " << opts.str())
+      }
+    }
+
+  // run stopped with SIGTERM once the timestepping loop has started (status.json is written at its start),
+  // the number of timesteps is large enough for the run not to finish before
+  {
+    ostringstream opts;
+    opts << "--outfreq=100000 --nt=100000 --dt=1 --serial=true --prs_tol=1e-3 --rng_seed=44 --nx=8 --nz=8 --case=dry_thermal --micro=none"
+         << " --prof=1 --status_interval=1 " << opts_additional;
+    const string outdir = "profiler/" + std::to_string(std::hash<std::string>{}(opts.str())) + "_stopped";
+
+    ostringstream cmd;
+    cmd << "sh -c '" << av[1] << "/../../build/uwlcm " << opts.str() << " --outdir=\"" << outdir << "\" & pid=$!;"
+        << " while kill -0 $pid 2>/dev/null && [ ! -f \"" << outdir << "/status.json\" ]; do sleep 0.1; done;"
+        << " kill -TERM $pid; wait $pid'";
+
+    cerr << endl << "=========" << endl;
+    notice_macro("about to call: " << cmd.str())
+
+    if (EXIT_SUCCESS != system(cmd.str().c_str()))
+      error_macro("stopped model run failed: " << cmd.str())
+
+    std::ifstream in(outdir + "/profile.json");
+    if (!in.good())
+      error_macro("profiler output of the stopped run not found: " << opts.str())
+    const string prof((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    if (prof.find("\"completed\": false") == string::npos)
+      error_macro("missing \"completed\": false in profiler output of the stopped run: " << opts.str())
+  }
+}